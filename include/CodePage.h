@@ -0,0 +1,156 @@
+#ifndef CODE_PAGE_H
+#define CODE_PAGE_H
+
+#include <stdint.h>
+#include <string.h>
+#include <string>
+
+//-- UTF-8 <-> Windows-1252 (Latin-1 plus the typographic characters in
+//-- 0x80..0x9F), the code page of the ExtASCII Parola font and of the
+//-- NeopixelsFont tables. A font that has the glyph gets the code page
+//-- character, for the others asciiFold() gives the nearest plain ASCII.
+//-- It has no ESP32 dependencies so it can be checked on a PC.
+
+#define CP_UNKNOWN  '?'     // for characters without a glyph and without a fold
+#define CP_OUTSIDE  0xFFFF  // valid UTF-8 above U+FFFF (emoji), never in a font
+
+// Decode the UTF-8 character at 'text' and advance 'text' past it.
+// Invalid sequences return CP_UNKNOWN for every byte, a valid character
+// above U+FFFF returns CP_OUTSIDE with 'text' past the whole sequence.
+inline uint16_t utf8NextCodePoint(const char*& text)
+{
+  uint8_t c = (uint8_t)*text++;
+  if (c < 0x80) return c;
+
+  uint8_t  extraBytes = (c >= 0xF0) ? 3 : (c >= 0xE0) ? 2 : (c >= 0xC0) ? 1 : 0;
+  uint32_t codePoint  = c & (0x3F >> extraBytes);
+  if (extraBytes == 0) return CP_UNKNOWN;
+
+  while (extraBytes--)
+  {
+    if (((uint8_t)*text & 0xC0) != 0x80) return CP_UNKNOWN;
+    codePoint = (codePoint << 6) | ((uint8_t)*text++ & 0x3F);
+  }
+  return (codePoint > 0xFFFF) ? CP_OUTSIDE : (uint16_t)codePoint;
+
+} // utf8NextCodePoint()
+
+
+// Write codePoint as UTF-8 plus a '\0' to 'out' (4 bytes), returns the length
+inline uint8_t utf8Encode(uint16_t codePoint, char* out)
+{
+  uint8_t length = 0;
+  if (codePoint < 0x80)
+  {
+    out[length++] = (char)codePoint;
+  }
+  else if (codePoint < 0x800)
+  {
+    out[length++] = (char)(0xC0 | (codePoint >> 6));
+    out[length++] = (char)(0x80 | (codePoint & 0x3F));
+  }
+  else
+  {
+    out[length++] = (char)(0xE0 | (codePoint >> 12));
+    out[length++] = (char)(0x80 | ((codePoint >> 6) & 0x3F));
+    out[length++] = (char)(0x80 | (codePoint & 0x3F));
+  }
+  out[length] = '\0';
+  return length;
+
+} // utf8Encode()
+
+
+// Unicode of the 0x80..0x9F code page characters, 0 = not used
+inline const uint16_t* cp1252Specials()
+{
+  static const uint16_t specials[32] =
+  {
+    0x20AC,      0, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,   // 0x80  € ‚ ƒ „ … † ‡
+    0x02C6, 0x2030, 0x0160, 0x2039, 0x0152,      0, 0x017D,      0,   // 0x88  ˆ ‰ Š ‹ Œ Ž
+         0, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,   // 0x90  ‘ ’ “ ” • – —
+    0x02DC, 0x2122, 0x0161, 0x203A, 0x0153,      0, 0x017E, 0x0178    // 0x98  ˜ ™ š › œ ž Ÿ
+  };
+  return specials;
+}
+
+// Unicode of a code page character
+inline uint16_t cp1252ToUnicode(uint8_t c)
+{
+  return (c >= 0x80 && c < 0xA0) ? cp1252Specials()[c - 0x80] : c;
+}
+
+// Code page character for a code point, 0 if the code page does not have it
+inline uint8_t cp1252FromUnicode(uint16_t codePoint)
+{
+  if (codePoint < 0x80 || (codePoint >= 0xA0 && codePoint <= 0xFF)) return (uint8_t)codePoint;
+  if (codePoint < 0x100) return 0;
+
+  const uint16_t* specials = cp1252Specials();
+  for (uint8_t i = 0; i < 32; i++)
+  {
+    if (specials[i] == codePoint) return 0x80 + i;
+  }
+  return 0;
+
+} // cp1252FromUnicode()
+
+
+// Plain ASCII (at most 3 characters plus '\0' in 'out') for a code point of
+// the code page or of Latin Extended-A, false if there is none
+inline bool asciiFold(uint16_t codePoint, char* out)
+{
+  static const char* const codePageFolds[128] =
+  {
+    "EUR", nullptr, ",",   "f",   "\"",  "...", "+",   "++",  "^",   "%",   "S",   "<",   "OE",  nullptr, "Z",   nullptr,  // 0x80
+    nullptr, "'",   "'",   "\"",  "\"",  "*",   "-",   "-",   "~",   "TM",  "s",   ">",   "oe",  nullptr, "z",   "Y",      // 0x90
+    " ",   "!",   "c",   "GBP", "*",   "JPY", "|",   "S",   "\"",  "(c)", "a",   "\"",  "-",   "",    "(r)", "-",      // 0xA0
+    "*",   "+/-", "2",   "3",   "'",   "u",   "P",   ".",   ",",   "1",   "o",   "\"",  "1/4", "1/2", "3/4", "?",      // 0xB0
+    "A",   "A",   "A",   "A",   "A",   "A",   "AE",  "C",   "E",   "E",   "E",   "E",   "I",   "I",   "I",   "I",      // 0xC0
+    "D",   "N",   "O",   "O",   "O",   "O",   "O",   "x",   "O",   "U",   "U",   "U",   "U",   "Y",   "TH",  "ss",     // 0xD0
+    "a",   "a",   "a",   "a",   "a",   "a",   "ae",  "c",   "e",   "e",   "e",   "e",   "i",   "i",   "i",   "i",      // 0xE0
+    "d",   "n",   "o",   "o",   "o",   "o",   "o",   "/",   "o",   "u",   "u",   "u",   "u",   "y",   "th",  "y"       // 0xF0
+  };
+  // U+0100..U+017F, every letter without its accent
+  static const char latinExtendedA[] =
+    "AaAaAaCcCcCcCcDdDdEeEeEeEeEeGgGgGgGgHhHhIiIiIiIiIiJjJjKkkLlLlLlLlLl"
+    "NnNnNnnNnOoOoOoOoRrRrRrSsSsSsSsTtTtTtUuUuUuUuUuUuWwYyYZzZzZzs";
+
+  uint8_t c = cp1252FromUnicode(codePoint);
+  if (c >= 0x80)
+  {
+    const char* fold = codePageFolds[c - 0x80];
+    if (fold == nullptr) return false;
+    strcpy(out, fold);
+    return true;
+  }
+  if (codePoint == 0x0132 || codePoint == 0x0133)   // IJ ligature
+  {
+    strcpy(out, (codePoint == 0x0132) ? "IJ" : "ij");
+    return true;
+  }
+  if (codePoint >= 0x0100 && codePoint < 0x0180)
+  {
+    out[0] = latinExtendedA[codePoint - 0x0100];
+    out[1] = '\0';
+    return true;
+  }
+  return false;
+
+} // asciiFold()
+
+
+// Append a code point to code page text. With 'withGlyphs' false (the font
+// has ASCII only) every character above 0x7F is folded to ASCII.
+inline void cp1252Append(uint16_t codePoint, std::string& result, bool withGlyphs = true)
+{
+  char    fold[4];
+  uint8_t c = cp1252FromUnicode(codePoint);
+
+  if (c != 0 && (withGlyphs || c < 0x80)) result.push_back((char)c);
+  else if (asciiFold(codePoint, fold))    result += fold;
+  else                                    result.push_back(CP_UNKNOWN);
+
+} // cp1252Append()
+
+#endif // CODE_PAGE_H
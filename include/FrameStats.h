@@ -0,0 +1,115 @@
+#ifndef FRAME_STATS_H
+#define FRAME_STATS_H
+
+#include <Arduino.h>
+
+//-- Frame time histograms for the display classes. Only compiled in with
+//-- -D FRAME_STATS, without it the FRAME_STATS_ macros are empty.
+
+#define FRAME_PHASE_BUILD      0   // build the frame (Parola: all of displayAnimate())
+#define FRAME_PHASE_SHOW       1   // send the frame to the LEDs
+#define FRAME_PHASE_CALLBACK   2   // onFinished() callback
+#define FRAME_PHASES           3
+
+#define FRAME_STATS_BUCKETS   12   // bucket 0: < 16us, bucket n: < (16us << n), the last one: the rest
+
+#ifdef FRAME_STATS
+  #define FRAME_STATS_BEGIN(start)               uint32_t start = ESP.getCycleCount()
+  #define FRAME_STATS_END(stats, phase, start)   stats.add(phase, ESP.getCycleCount() - start)
+#else
+  #define FRAME_STATS_BEGIN(start)
+  #define FRAME_STATS_END(stats, phase, start)
+#endif
+
+class FrameStats
+{
+public:
+  // Cheap enough for every frame: one division, a clz and a few adds
+  void add(uint8_t phase, uint32_t cycles)
+  {
+    if (cpuMHz == 0) cpuMHz = ESP.getCpuFreqMHz();
+    uint32_t us = cycles / cpuMHz;
+    uint32_t slots = us >> 4;
+    uint8_t bucket = (slots == 0) ? 0 : 32 - __builtin_clz(slots);
+    if (bucket >= FRAME_STATS_BUCKETS) bucket = FRAME_STATS_BUCKETS - 1;
+
+    counts[phase][bucket]++;
+    samples[phase]++;
+    totalUs[phase] += us;
+    if (us > maxUs[phase]) maxUs[phase] = us;
+  }
+
+  void reset()
+  {
+    memset(counts, 0, sizeof(counts));
+    memset(samples, 0, sizeof(samples));
+    memset(totalUs, 0, sizeof(totalUs));
+    memset(maxUs, 0, sizeof(maxUs));
+  }
+
+  // {"bucketUs":[16,32,..],"build":{"count":n,"avgUs":n,"maxUs":n,"hist":[..]},"show":{..},"callback":{..}}
+  String toJson() const
+  {
+    char part[24];
+    String json = "{\"bucketUs\":[";
+    for (uint8_t b = 0; b < FRAME_STATS_BUCKETS - 1; b++)
+    {
+      snprintf(part, sizeof(part), "%s%u", (b ? "," : ""), 16u << b);
+      json += part;
+    }
+    json += "]";
+    for (uint8_t phase = 0; phase < FRAME_PHASES; phase++)
+    {
+      json += ",\"";
+      json += phaseName(phase);
+      snprintf(part, sizeof(part), "\":{\"count\":%u", samples[phase]);
+      json += part;
+      snprintf(part, sizeof(part), ",\"avgUs\":%u", averageUs(phase));
+      json += part;
+      snprintf(part, sizeof(part), ",\"maxUs\":%u", maxUs[phase]);
+      json += part;
+      json += ",\"hist\":[";
+      for (uint8_t b = 0; b < FRAME_STATS_BUCKETS; b++)
+      {
+        snprintf(part, sizeof(part), "%s%u", (b ? "," : ""), counts[phase][b]);
+        json += part;
+      }
+      json += "]}";
+    }
+    json += "}";
+    return json;
+  }
+
+  // One line per phase, for the ticker monitor
+  String toText(uint8_t phase) const
+  {
+    char line[200];
+    int len = snprintf(line, sizeof(line), "%-8s n[%u] avg[%uus] max[%uus] |"
+                                         , phaseName(phase), samples[phase], averageUs(phase), maxUs[phase]);
+    for (uint8_t b = 0; b < FRAME_STATS_BUCKETS && len < (int)sizeof(line); b++)
+    {
+      len += snprintf(line + len, sizeof(line) - len, " %u", counts[phase][b]);
+    }
+    return String(line);
+  }
+
+private:
+  uint32_t counts[FRAME_PHASES][FRAME_STATS_BUCKETS] = {{0}};
+  uint32_t samples[FRAME_PHASES] = {0};
+  uint64_t totalUs[FRAME_PHASES] = {0};
+  uint32_t maxUs[FRAME_PHASES] = {0};
+  uint32_t cpuMHz = 0;
+
+  uint32_t averageUs(uint8_t phase) const
+  {
+    return samples[phase] ? (uint32_t)(totalUs[phase] / samples[phase]) : 0;
+  }
+
+  static const char* phaseName(uint8_t phase)
+  {
+    static const char* names[FRAME_PHASES] = {"build", "show", "callback"};
+    return names[phase];
+  }
+};
+
+#endif // FRAME_STATS_H
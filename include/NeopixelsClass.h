@@ -5,10 +5,35 @@
 #include <Adafruit_NeoMatrix.h>
 #include <Adafruit_NeoPixel.h>
 #include <Arduino.h>
+#include "FrameStats.h"
+#include "VirtualMatrix.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <esp_idf_version.h>
+#if ESP_IDF_VERSION_MAJOR < 5
+  #include <driver/rmt.h>
+  #include <esp_intr_alloc.h>
+#endif
 #include <string>
 #include <vector>
 
+#define NEO_MAX_SEGMENTS  8   // messages that can be in the scroll ring at once
+#define NEO_MAX_PANELS    8   // panels side by side (see setPanels())
+#define NEO_SUBPIXEL_STEPS 16  // finest sub-pixel scroll step: 1/16 column
+#define NEO_MAX_ROWS      4   // ticker rows above each other (see setRows())
+#define NEO_ROW_QUEUE     4   // texts that can wait for an extra ticker row
+
 //-- needed to have a true dropin replacement for the ParolaClass
+//-- effect ids as MD_Parola numbers them (all ENA_ options on), so the same
+//-- setRandomEffects() list works for both
+enum textEffect_t : uint8_t
+{
+  PA_NO_EFFECT, PA_PRINT, PA_SCROLL_UP, PA_SCROLL_DOWN, PA_SCROLL_LEFT, PA_SCROLL_RIGHT,
+  PA_SPRITE, PA_SLICE, PA_MESH, PA_FADE, PA_DISSOLVE, PA_BLINDS, PA_RANDOM,
+  PA_WIPE, PA_WIPE_CURSOR
+};
+
 struct DisplayConfig
 {
     uint16_t speed;         // Animation speed
@@ -32,20 +57,187 @@ private:
   int red, green, blue;
   std::string text;
   int pixelPerChar;
+  bool proportionalFont = false;  // ExtASCII glyphs (NeopixelsFont.h) instead of the classic GFX font
   int scrollDelay;
   int brightness;
   int textScrollPosition;
   int pass;
   bool textComplete;
-  unsigned long lastUpdateTime;
+  unsigned long lastUpdateTime;      // micros() of the last scroll clock update (0 = restart clock)
+  uint32_t scrollRemainderUs = 0;    // Time since the last whole pixel step (sub-pixel part)
+  int skipColumns = 0;               // Columns to skip before the next frame (late frame)
+  uint32_t lateFrames = 0;           // Frames that were more than one step late
+  uint32_t droppedFrames = 0;        // Frames skipped to catch up
+  uint32_t unchangedFrames = 0;      // Frames not built or sent, the LEDs already showed them
   bool initialized = false;
   bool matrixInitialized = false;
   bool configInitialized = false;
-  std::string previousText;  // Store the previous text for continuous scrolling
   bool readyForNextMessage = false;  // Flag to indicate we're ready for the next message
   int lastStopPosition = 0;  // Store the last stop position for continuous scrolling
+  uint16_t textColor = 0;    // Current text color (565) as used by the GFX functions
+  
+  // Scrolling text: a ring of rendered messages, textScrollPosition is the x
+  // of the first column of the head (oldest) segment
+  struct TextSegment
+  {
+    std::string text;               // message, with the "*" separator when appended
+    std::vector<uint16_t> columns;  // rendered text, one entry per column (bit y = row y)
+    uint8_t color[4];               // colour of the whole segment, as pixelBytes
+  };
+  TextSegment segments[NEO_MAX_SEGMENTS];
+  uint8_t segmentHead = 0;
+  uint8_t segmentCount = 0;
+  int ringWidth = 0;         // columns in all segments together
+  
+  // A text that fits the display is padded to the display width, the ring
+  // stops with it centred and it stands still for staticDwellMs
+  uint32_t staticDwellMs = 0;  // 0 = every text scrolls
+  bool staticText = false;     // the last segment is such a text
+  bool dwelling = false;       // it stands still since dwellStart
+  uint32_t dwellStart = 0;
+  
+  // Layers around and over the scrolling text, each with its own rendered
+  // bitmap that is only rendered again when its text changes. The static
+  // layer takes the left columns (a clock), the text scrolls in the columns
+  // right of it (tickerX .. tickerX + tickerWidth - 1) and the overlay is
+  // drawn on top of both.
+  struct Layer
+  {
+    std::string text;               // what the columns were rendered from
+    std::vector<uint16_t> columns;  // bit y = row y
+    uint8_t color[4] = {0};         // its own colour, in the byte order of pixelBytes
+    int x = 0;                      // clip rectangle: columns x .. x + width - 1, all rows
+    int width = 0;                  // 0 = no layer
+    bool drawn[2] = {false, false}; // per frame buffer: it holds these columns
+  };
+  Layer staticLayer;
+  Layer overlayLayer;
+  int tickerX = 0;
+  int tickerWidth = 0;
+  int tickerHeight = 0;      // rows of the scrolling text (the top ticker row)
+  
+  // Extra ticker rows under the scrolling text, each tickerHeight rows high
+  // over the full width. Every row has its own text queue, speed and rendered
+  // strip and is drawn into the same frame, so one show() sends all rows.
+  struct QueuedText
+  {
+    std::string text;               // keeps its capacity for the next text
+    uint8_t color[4];
+  };
+  struct TickerRow
+  {
+    QueuedText queue[NEO_ROW_QUEUE];
+    uint8_t queueHead = 0;
+    uint8_t queueCount = 0;
+    std::string text;               // the text that scrolls now
+    std::vector<uint16_t> columns;  // rendered text, bit y = row y of the ticker row
+    uint8_t color[4] = {0};
+    int position = 0;               // x of the first column
+    int scrollDelay = 50;           // ms per column
+    bool scrolling = false;
+    unsigned long lastUpdateTime = 0;  // micros() of the last clock update (0 = restart clock)
+    uint32_t remainderUs = 0;
+    uint32_t version = 1;           // counts every change of what the row shows
+    uint32_t drawn[2] = {0, 0};     // per frame buffer: the version it holds (0 = none)
+    uint32_t level[2] = {0, 0};     // per frame buffer: gamma levels of the row
+    bool finishedPending = false;   // queue ran empty, onRowFinished() not yet called (under frameMux)
+    std::string finishedText;
+  };
+  TickerRow rows[NEO_MAX_ROWS - 1];  // ticker row r is rows[r - 1]
+  int wantedRows = 1;        // as set by setRows()
+  int tickerRows = 1;        // as many of them as fit the matrix height
+  
+  // Incremental scrolling: shift the NeoPixel buffer and only draw the new column
+  std::vector<uint16_t> pixelMap;  // (y * width + x) -> pixel index in the NeoPixel buffer
+  uint8_t shiftMode = 0;     // How the buffer can be shifted (see buildPixelMap())
+  int shiftDelta = 0;        // Buffer offset between a pixel and its right neighbour
+  uint8_t bytesPerPixel = 3;
+  bool incrementalScroll = true;
+  bool frameValid = false;   // NeoPixel buffer holds the frame for lastFramePosition
+  int lastFramePosition = 0;
+  
+  // Double buffered frame: buildFrame() writes the back buffer, outputFrame()
+  // swaps it to the front and sends the front buffer to the LEDs
+  std::vector<uint8_t> frameBuffer[2];
+  volatile uint8_t frontBuffer = 0;
+  portMUX_TYPE frameMux = portMUX_INITIALIZER_UNLOCKED;
+  uint8_t pixelBytes[4] = {0};  // textColor as it is stored in the buffer (LED byte order)
+  bool rmtOutput = false;    // Frames go out by the RMT peripheral instead of Adafruit show()
+  
+  // Panels of width x height side by side, divided over the data pins in
+  // order. Every pin has its own RMT channel, so the pins send together.
+  struct PanelOutput
+  {
+    uint8_t pin;
+    uint8_t channel;   // RMT channel
+    size_t  offset;    // first byte in the NeoPixel buffer
+    size_t  size;      // bytes of all panels on this pin
+  };
+  int panels = 1;
+  std::vector<uint8_t> panelPins;      // empty: all panels are chained on neopixelPin
+  std::vector<PanelOutput> outputs;
+  bool outputsValid = false;           // the LEDs show the front buffer (see sendFrontBuffer())
+  
+  // Output stage: frame bytes -> LED bytes (gamma, brightness and dithering)
+  uint16_t levelLut[256];    // 8.8 fixed point LED value per colour value
+  uint16_t fadeLut[256];     // levelLut scaled by fadeLevel, for the scrolling text only
+  uint16_t gammaLut[256] = {0};  // 8.8 fixed point gamma corrected colour value
+  int lutBrightness = -1;    // brightness levelLut was built for (-1 = build it)
+  float gamma = 2.6f;
+  float lutGamma = 0;        // gamma gammaLut was built for
+  bool dithering = false;
+  uint8_t ditherPhase = 0;
+  
+  // Sub-pixel scrolling: between two pixel steps the text is drawn part of
+  // the way, every LED a blend of the two text columns that pass it
+  bool subPixelScroll = false;
+  uint8_t subPixelPhase = 0;   // 1/16 columns past the last pixel step on the LEDs
+  uint16_t blendWeight[NEO_SUBPIXEL_STEPS + 1] = {0};  // 8.8 colour scale for 0/16 .. 16/16 of the light
+  
+  // Power budget: the gamma levels of every frame buffer are summed per
+  // column while a frame is built, so a scroll step only adds one column
+  std::vector<uint16_t> columnLevel[2];  // per frame buffer: gamma levels per column
+  uint32_t frameLevel[2] = {0, 0};       // per frame buffer: all columns
+  int maxMilliAmps = 0;                  // 0 = no budget
+  uint16_t powerLevel = 256;             // levelLut scale to stay within the budget (256 = full)
+  uint16_t lutPowerLevel = 256;
+  uint16_t fadeLevel = 256;              // fadeLut scale of the PA_FADE exit effect (256 = full)
+  uint16_t lutFadeLevel = 256;
+  uint32_t estimatedMilliAmps = 0;
+  
+  // Exit effect: played on the last frame of a text when the effect picked
+  // from effectList is not PA_NO_EFFECT, else the next text scrolls in behind
+  // it. Every effect frame is a function of the source frame and effectFrame.
+  std::vector<uint8_t> effectList;
+  std::vector<uint16_t> dissolveOrder;  // buffer pixel indices in LFSR order
+  std::vector<uint8_t> effectSource;    // the frame the effect starts from
+  uint8_t effect = PA_NO_EFFECT;        // running effect
+  int effectFrame = 0;
+  int effectFrames = 0;
+  
+  // Render task: owns the matrix once started, the other tasks post commands
+  struct RenderCommand
+  {
+    uint8_t type;
+    int     value[4];
+    char*   text;     // strdup()'d by the sender, freed by the render task
+  };
+  TaskHandle_t  renderTaskHandle = nullptr;
+  QueueHandle_t renderQueue = nullptr;
+  volatile bool renderTaskRunning = false;
+  bool finishedPending = false;   // Text completed, onFinished() not yet called (under frameMux)
+  std::string finishedText;
 
   std::function<void(const std::string&)> onFinished = nullptr;
+  std::function<void(int, const std::string&)> onRowFinished = nullptr;
+  
+#ifdef FRAME_STATS
+  FrameStats frameStats;
+#endif
+  
+  // Copy of every frame as it goes to the LEDs, only when a sink is set
+  VirtualMatrix virtualMatrix;
+  VirtualMatrix::Sink frameSink = nullptr;
   
   // Debug support
   Stream* debug = nullptr;
@@ -54,7 +246,70 @@ private:
   // Private helper methods
   int16_t scaleValue(int16_t input, int16_t minInValue, int16_t maxInValue, int16_t minOutValue, int16_t maxOutValue);
   void cleanup();
-  void trimTextAndRecalculate();
+  void renderText(const std::string& text, std::vector<uint16_t>& columns);
+  void centreColumns(std::vector<uint16_t>& columns, int columnsWide);
+  void appendSegment(const std::string& segmentText, bool centred = false);
+  void releaseHeadSegment();
+  void releaseScrolledSegments();
+  void clearSegments();
+  uint16_t segmentColumn(int column, const uint8_t*& color);
+  bool frameChanged(int xPosition);
+  void showPosition(int xPosition);
+  int  charSpacing();
+  uint8_t nextGlyph(const char*& p, const uint8_t*& columns);
+  uint32_t scrollStepUs();
+  uint32_t frameUs();
+  void buildPixelMap();
+  void updateTickerWindow();
+  void drawStaticLayer(uint8_t buffer);
+  void drawOverlay(uint8_t buffer);
+  void repairOverlay(uint8_t buffer, int xPosition);
+  bool layersChanged() const;
+  bool rowsChanged() const;
+  void drawRows(uint8_t buffer);
+  void copyRows(uint8_t from, uint8_t to);
+  void invalidateRows(uint8_t buffer);
+  void startRowText(TickerRow& row);
+  void stepRows(bool triggerCallback);
+  void showRows();
+  uint32_t rowWaitUs();
+  void updatePixelBytes();
+  void toPixelBytes(int r, int g, int b, uint8_t* bytes);
+  void buildFrame(int xPosition);
+  void buildBlendedFrame(int xPosition, uint8_t phase);
+  void showSubPixel(uint32_t remainderUs, uint32_t stepUs);
+  uint8_t subPixelSteps(uint32_t stepUs);
+  void shiftFrameLeft(const uint8_t* src, uint8_t* dst);
+  void drawColumn(uint8_t* buffer, int x, uint16_t bits, const uint8_t* color, int top = 0);
+  void outputFrame();
+  void clearFrame();
+  void sendFrontBuffer();
+  void buildLevelLut();
+  uint16_t colorLevel(const uint8_t* color);
+  uint16_t measureColumn(uint8_t buffer, int x);
+  void sumLevels(uint8_t buffer);
+  void measureFrame(uint8_t buffer);
+  void updatePowerLevel();
+  void applyLevelLut(const uint8_t* src, uint8_t* dst, size_t size);
+  void applyFadeLut(const uint8_t* src, uint8_t* dst, size_t offset, size_t size);
+  bool overlayPixel(int x, int y) const;
+  void captureFrame(const uint8_t* pixels);
+  void buildDissolveOrder();
+  bool startEffect();
+  void stopEffect();
+  bool animateEffect(bool triggerCallback);
+  void buildEffectFrame(int frame);
+  bool finishText(bool triggerCallback);
+  void postFinished(std::string& slot, bool& pending, const std::string& text);
+  bool takeFinished(std::string& slot, bool& pending, std::string& text);
+  bool beginRmtOutput();
+  void endRmtOutput();
+  void stepScrollClock(bool triggerCallback);
+  bool postCommand(uint8_t type, int v0 = 0, int v1 = 0, int v2 = 0, int v3 = 0, const char* text = nullptr);
+  bool inRenderTask() const;
+  void handleCommand(RenderCommand& command);
+  void renderLoop();
+  static void renderTask(void* parameter);
 
 public:
   // Constructor and destructor
@@ -66,7 +321,9 @@ public:
   void setup(uint8_t matrixType, uint8_t matrixLayout, uint8_t matrixDirection, uint8_t matrixSequence);
   void setPixelType(neoPixelType pixelType);
   void setMatrixSize(int width, int height);
+  void setPanels(int panels, const std::vector<uint8_t>& pins);
   void setPixelsPerChar(int pixels);
+  void setProportionalFont(bool enable) { proportionalFont = enable; }
   void setDebug(Stream* debugPort = &Serial);
   //void initializeDisplay();
   
@@ -74,7 +331,21 @@ public:
   void setColor(int r, int g, int b);
   void setIntensity(int newBrightness);
   void setScrollSpeed(int newSpeed);
+  void setGamma(float newGamma) { gamma = (newGamma > 0) ? newGamma : 1.0f; lutBrightness = -1; }
+  void setDithering(bool enable) { dithering = enable; }
+  void setSubPixelScroll(bool enable) { subPixelScroll = enable; }
+  void setPowerBudget(int milliAmps) { maxMilliAmps = std::max(0, milliAmps); }
+  uint32_t getEstimatedMilliAmps() const { return estimatedMilliAmps; }
+  void setIncrementalScroll(bool enable) { incrementalScroll = enable; frameValid = false; }
+  void setStaticDwell(uint32_t milliSeconds) { staticDwellMs = milliSeconds; }
   void sendNextText(const std::string& text);
+  void setStaticText(const std::string& text, int columns, int r, int g, int b);
+  void setOverlayText(const std::string& text, int x, int r, int g, int b);
+  void setRows(int rows);
+  void sendRowText(int row, const std::string& text, int r, int g, int b);
+  void setRowSpeed(int row, int speed);
+  void setRowCallback(std::function<void(int, const std::string&)> callback) { onRowFinished = callback; }
+  uint16_t measureText(const std::string& text);
   bool animateNeopixels(bool triggerCallback = true);  
   void animateBlocking(const String &text);
   void loop();
@@ -82,9 +353,20 @@ public:
   void show();
   void setRandomEffects(const std::vector<uint8_t> &effects);
   void setCallback(std::function<void(const std::string&)> callback);
+  void setFrameSink(VirtualMatrix::Sink sink) { frameSink = sink; }
   void setDisplayConfig(const DisplayConfig &config);
   bool isInitialized() const { return initialized; }
+  uint32_t getLateFrames() const { return lateFrames; }
+  uint32_t getDroppedFrames() const { return droppedFrames; }
+  uint32_t getUnchangedFrames() const { return unchangedFrames; }
+  void resetFrameCounters() { lateFrames = 0; droppedFrames = 0; unchangedFrames = 0; }
+#ifdef FRAME_STATS
+  const FrameStats& getFrameStats() const { return frameStats; }
+  void resetFrameStats() { frameStats.reset(); }
+#endif
   void reset();
+  bool startRenderTask(uint8_t core = 1);
+  void stopRenderTask();
 
 #ifdef NEOPIXELS_DEBUG
     bool doDebug = true;
@@ -0,0 +1,60 @@
+#ifndef NEOPIXELS_ENCODER_H
+#define NEOPIXELS_ENCODER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+//-- Converts NeoPixel buffer bytes into RMT symbols (one symbol per bit, MSB
+//-- first). It has no ESP32 dependencies so it can be checked on a PC.
+
+#define NEO_RMT_CLK_DIV   2   // 80MHz APB / 2 -> one RMT tick is 25ns
+
+// Length of the high and low part of a 0 and a 1 bit, in RMT ticks
+struct NeoBitTiming
+{
+  uint16_t t0h;
+  uint16_t t0l;
+  uint16_t t1h;
+  uint16_t t1l;
+};
+
+static constexpr NeoBitTiming neoTiming800 = {16, 34, 32, 18};  // 0.40/0.85us, 0.80/0.45us
+static constexpr NeoBitTiming neoTiming400 = {20, 80, 48, 52};  // 0.50/2.00us, 1.20/1.30us
+
+// One symbol as the 32 bits of an rmt_item32_t: 'high' ticks level 1, then 'low' ticks level 0
+constexpr uint32_t neoSymbol(uint16_t high, uint16_t low)
+{
+  return (uint32_t)(high & 0x7FFF) | (1UL << 15) | ((uint32_t)(low & 0x7FFF) << 16);
+}
+
+// Encode as many whole bytes of src as fit in destSize symbols. Returns the
+// number of symbols written, bytesUsed is set to the number of bytes encoded.
+// Always inlined: the RMT translators that call it run from IRAM.
+inline __attribute__((always_inline)) size_t neoEncodeBytes(const uint8_t* src, size_t srcSize
+                           , uint32_t* dest, size_t destSize
+                           , const NeoBitTiming& timing, size_t& bytesUsed)
+{
+  const uint32_t zero = neoSymbol(timing.t0h, timing.t0l);
+  const uint32_t one  = neoSymbol(timing.t1h, timing.t1l);
+  size_t bytes = destSize / 8;
+  if (bytes > srcSize) bytes = srcSize;
+
+  for (size_t i = 0; i < bytes; i++)
+  {
+    uint8_t value = src[i];
+    dest[0] = (value & 0x80) ? one : zero;
+    dest[1] = (value & 0x40) ? one : zero;
+    dest[2] = (value & 0x20) ? one : zero;
+    dest[3] = (value & 0x10) ? one : zero;
+    dest[4] = (value & 0x08) ? one : zero;
+    dest[5] = (value & 0x04) ? one : zero;
+    dest[6] = (value & 0x02) ? one : zero;
+    dest[7] = (value & 0x01) ? one : zero;
+    dest += 8;
+  }
+  bytesUsed = bytes;
+  return bytes * 8;
+
+} // neoEncodeBytes()
+
+#endif // NEOPIXELS_ENCODER_H
@@ -0,0 +1,335 @@
+/*
+**  NeopixelsFont.h
+**
+**  The two fonts of the NeopixelsClass, both 8 pixels high with one byte
+**  per column, bit0 is the top row:
+**  - classic: the 5x7 Adafruit GFX font the matrix always used (its own
+**    glcdfont.c, code page 437). Every character takes "Pixels per
+**    Character" columns.
+**  - proportional (opt-in): the glyphs of the ExtASCII Parola font, ASCII
+**    plus the Windows-1252 characters (see CodePage.h), every glyph has its
+**    own width.
+**  The widths are known without drawing, so a text can be measured when it
+**  is queued.
+*/
+#pragma once
+#include <Arduino.h>
+#include <glcdfont.c>   // Adafruit GFX: font[], 5 bytes per character
+#include "CodePage.h"
+
+#define NEO_CLASSIC_WIDTH     5   // glyph columns of the classic font
+#define NEO_FONT_HEIGHT       8
+#define NEO_FONT_MAX_WIDTH    8   // widest glyph in columns
+#define NEO_FONT_FIRST     0x20   // ' '
+#define NEO_FONT_LAST      0x7E   // '~'
+#define NEO_FONT_CP_FIRST  0x80   // first code page character in neoFontCodePage
+#define NEO_FONT_UNKNOWN    '?'   // shown for characters without a glyph
+
+struct NeoGlyph
+{
+  uint8_t width;                        // number of columns
+  uint8_t columns[NEO_FONT_MAX_WIDTH];  // bit0 = top row
+};
+
+static constexpr NeoGlyph neoFont[] =
+{
+  { 2, {   0,   0 } },                            // 0x20 ' '
+  { 1, {  95 } },                                 // 0x21 '!'
+  { 3, {   7,   0,   7 } },                       // 0x22 '"'
+  { 5, {  20, 127,  20, 127,  20 } },             // 0x23 '#'
+  { 5, {  36,  42, 127,  42,  18 } },             // 0x24 '$'
+  { 5, {  35,  19,   8, 100,  98 } },             // 0x25 '%'
+  { 5, {  54,  73,  86,  32,  80 } },             // 0x26 '&'
+  { 2, {   4,   3 } },                            // 0x27 '''
+  { 3, {  28,  34,  65 } },                       // 0x28 '('
+  { 3, {  65,  34,  28 } },                       // 0x29 ')'
+  { 5, {  42,  28, 127,  28,  42 } },             // 0x2A '*'
+  { 5, {   8,   8,  62,   8,   8 } },             // 0x2B '+'
+  { 2, { 128,  96 } },                            // 0x2C ','
+  { 5, {   8,   8,   8,   8,   8 } },             // 0x2D '-'
+  { 2, {  96,  96 } },                            // 0x2E '.'
+  { 5, {  32,  16,   8,   4,   2 } },             // 0x2F '/'
+  { 5, {  62,  81,  73,  69,  62 } },             // 0x30 '0'
+  { 3, {  66, 127,  64 } },                       // 0x31 '1'
+  { 5, { 114,  73,  73,  73,  70 } },             // 0x32 '2'
+  { 5, {  33,  65,  73,  77,  51 } },             // 0x33 '3'
+  { 5, {  24,  20,  18, 127,  16 } },             // 0x34 '4'
+  { 5, {  39,  69,  69,  69,  57 } },             // 0x35 '5'
+  { 5, {  60,  74,  73,  73,  49 } },             // 0x36 '6'
+  { 5, {  65,  33,  17,   9,   7 } },             // 0x37 '7'
+  { 5, {  54,  73,  73,  73,  54 } },             // 0x38 '8'
+  { 5, {  70,  73,  73,  41,  30 } },             // 0x39 '9'
+  { 1, {  20 } },                                 // 0x3A ':'
+  { 2, { 128, 104 } },                            // 0x3B ';'
+  { 4, {   8,  20,  34,  65 } },                  // 0x3C '<'
+  { 5, {  20,  20,  20,  20,  20 } },             // 0x3D '='
+  { 4, {  65,  34,  20,   8 } },                  // 0x3E '>'
+  { 5, {   2,   1,  89,   9,   6 } },             // 0x3F '?'
+  { 5, {  62,  65,  93,  89,  78 } },             // 0x40 '@'
+  { 5, { 124,  18,  17,  18, 124 } },             // 0x41 'A'
+  { 5, { 127,  73,  73,  73,  54 } },             // 0x42 'B'
+  { 5, {  62,  65,  65,  65,  34 } },             // 0x43 'C'
+  { 5, { 127,  65,  65,  65,  62 } },             // 0x44 'D'
+  { 5, { 127,  73,  73,  73,  65 } },             // 0x45 'E'
+  { 5, { 127,   9,   9,   9,   1 } },             // 0x46 'F'
+  { 5, {  62,  65,  65,  81, 115 } },             // 0x47 'G'
+  { 5, { 127,   8,   8,   8, 127 } },             // 0x48 'H'
+  { 3, {  65, 127,  65 } },                       // 0x49 'I'
+  { 5, {  32,  64,  65,  63,   1 } },             // 0x4A 'J'
+  { 5, { 127,   8,  20,  34,  65 } },             // 0x4B 'K'
+  { 5, { 127,  64,  64,  64,  64 } },             // 0x4C 'L'
+  { 5, { 127,   2,  28,   2, 127 } },             // 0x4D 'M'
+  { 5, { 127,   4,   8,  16, 127 } },             // 0x4E 'N'
+  { 5, {  62,  65,  65,  65,  62 } },             // 0x4F 'O'
+  { 5, { 127,   9,   9,   9,   6 } },             // 0x50 'P'
+  { 5, {  62,  65,  81,  33,  94 } },             // 0x51 'Q'
+  { 5, { 127,   9,  25,  41,  70 } },             // 0x52 'R'
+  { 5, {  38,  73,  73,  73,  50 } },             // 0x53 'S'
+  { 5, {   3,   1, 127,   1,   3 } },             // 0x54 'T'
+  { 5, {  63,  64,  64,  64,  63 } },             // 0x55 'U'
+  { 5, {  31,  32,  64,  32,  31 } },             // 0x56 'V'
+  { 5, {  63,  64,  56,  64,  63 } },             // 0x57 'W'
+  { 5, {  99,  20,   8,  20,  99 } },             // 0x58 'X'
+  { 5, {   3,   4, 120,   4,   3 } },             // 0x59 'Y'
+  { 5, {  97,  89,  73,  77,  67 } },             // 0x5A 'Z'
+  { 3, { 127,  65,  65 } },                       // 0x5B '['
+  { 5, {   2,   4,   8,  16,  32 } },             // 0x5C '\'
+  { 3, {  65,  65, 127 } },                       // 0x5D ']'
+  { 5, {   4,   2,   1,   2,   4 } },             // 0x5E '^'
+  { 5, {  64,  64,  64,  64,  64 } },             // 0x5F '_'
+  { 2, {   3,   4 } },                            // 0x60 '`'
+  { 5, {  32,  84,  84, 120,  64 } },             // 0x61 'a'
+  { 5, { 127,  40,  68,  68,  56 } },             // 0x62 'b'
+  { 5, {  56,  68,  68,  68,  40 } },             // 0x63 'c'
+  { 5, {  56,  68,  68,  40, 127 } },             // 0x64 'd'
+  { 5, {  56,  84,  84,  84,  24 } },             // 0x65 'e'
+  { 4, {   8, 126,   9,   2 } },                  // 0x66 'f'
+  { 5, {  24, 164, 164, 156, 120 } },             // 0x67 'g'
+  { 5, { 127,   8,   4,   4, 120 } },             // 0x68 'h'
+  { 3, {  68, 125,  64 } },                       // 0x69 'i'
+  { 4, {  64, 128, 128, 122 } },                  // 0x6A 'j'
+  { 4, { 127,  16,  40,  68 } },                  // 0x6B 'k'
+  { 3, {  65, 127,  64 } },                       // 0x6C 'l'
+  { 5, { 124,   4, 120,   4, 120 } },             // 0x6D 'm'
+  { 5, { 124,   8,   4,   4, 120 } },             // 0x6E 'n'
+  { 5, {  56,  68,  68,  68,  56 } },             // 0x6F 'o'
+  { 5, { 252,  24,  36,  36,  24 } },             // 0x70 'p'
+  { 5, {  24,  36,  36,  24, 252 } },             // 0x71 'q'
+  { 5, { 124,   8,   4,   4,   8 } },             // 0x72 'r'
+  { 5, {  72,  84,  84,  84,  36 } },             // 0x73 's'
+  { 4, {   4,  63,  68,  36 } },                  // 0x74 't'
+  { 5, {  60,  64,  64,  32, 124 } },             // 0x75 'u'
+  { 5, {  28,  32,  64,  32,  28 } },             // 0x76 'v'
+  { 5, {  60,  64,  48,  64,  60 } },             // 0x77 'w'
+  { 5, {  68,  40,  16,  40,  68 } },             // 0x78 'x'
+  { 5, {  76, 144, 144, 144, 124 } },             // 0x79 'y'
+  { 5, {  68, 100,  84,  76,  68 } },             // 0x7A 'z'
+  { 3, {   8,  54,  65 } },                       // 0x7B '{'
+  { 1, { 119 } },                                 // 0x7C '|'
+  { 3, {  65,  54,   8 } },                       // 0x7D '}'
+  { 5, {   2,   1,   2,   4,   2 } },             // 0x7E '~'
+};
+
+// Code page characters 0x80..0xFF, the entries with width 0 are not used
+static constexpr NeoGlyph neoFontCodePage[] =
+{
+  { 6, {  20,  62,  85,  85,  65,  34 } },          // 0x80 'Euro sign'
+  { 0, {   0 } },                                   // 0x81 'Not used'
+  { 2, { 128,  96 } },                              // 0x82 'Single low 9 quotation mark'
+  { 5, { 192, 136, 126,   9,   3 } },               // 0x83 'f with hook'
+  { 4, { 128,  96, 128,  96 } },                    // 0x84 'Single low 9 quotation mark'
+  { 8, {  96,  96,   0,  96,  96,   0,  96,  96 } },// 0x85 'Horizontal ellipsis'
+  { 3, {   4, 126,   4 } },                         // 0x86 'Dagger'
+  { 3, {  20, 126,  20 } },                         // 0x87 'Double dagger'
+  { 4, {   2,   1,   1,   2 } },                    // 0x88 'Modifier circumflex'
+  { 7, {  35,  19, 104, 100,   2,  97,  96 } },     // 0x89 'Per mille sign'
+  { 5, {  72,  85,  86,  85,  36 } },               // 0x8A 'S with caron'
+  { 3, {   8,  20,  34 } },                         // 0x8B '< quotation'
+  { 6, {  62,  65,  65, 127,  73,  73 } },          // 0x8C 'OE'
+  { 0, {   0 } },                                   // 0x8D 'Not used'
+  { 5, {  68, 101,  86,  77,  68 } },               // 0x8E 'z with caron'
+  { 0, {   0 } },                                   // 0x8F 'Not used'
+  { 0, {   0 } },                                   // 0x90 'Not used'
+  { 2, {   3,   4 } },                              // 0x91 'Left single quote mark'
+  { 2, {   4,   3 } },                              // 0x92 'Right single quote mark'
+  { 4, {   3,   4,   3,   4 } },                    // 0x93 'Left double quote marks'
+  { 4, {   4,   3,   4,   3 } },                    // 0x94 'Right double quote marks'
+  { 4, {   0,  24,  60,  24 } },                    // 0x95 'Bullet Point'
+  { 3, {   8,   8,   8 } },                         // 0x96 'En dash'
+  { 5, {   8,   8,   8,   8,   8 } },               // 0x97 'Em dash'
+  { 4, {   2,   1,   2,   1 } },                    // 0x98 'Small ~'
+  { 7, {   1,  15,   1,   0,  15,   2,  15 } },     // 0x99 'TM'
+  { 5, {  72,  85,  86,  85,  36 } },               // 0x9A 's with caron'
+  { 3, {  34,  20,   8 } },                         // 0x9B '> quotation'
+  { 7, {  56,  68,  68, 124,  84,  84,   8 } },     // 0x9C 'oe'
+  { 0, {   0 } },                                   // 0x9D 'Not used'
+  { 5, {  68, 101,  86,  77,  68 } },               // 0x9E 'z with caron'
+  { 5, {  12,  17,  96,  17,  12 } },               // 0x9F 'Y diaresis'
+  { 2, {   0,   0 } },                              // 0xA0 'Non-breaking space'
+  { 1, { 125 } },                                   // 0xA1 'Inverted !'
+  { 5, {  60,  36, 126,  36,  36 } },               // 0xA2 'Cent sign'
+  { 5, {  72, 126,  73,  65, 102 } },               // 0xA3 'Pound sign'
+  { 5, {  34,  28,  20,  28,  34 } },               // 0xA4 'Currency sign'
+  { 5, {  43,  47, 252,  47,  43 } },               // 0xA5 'Yen'
+  { 1, { 119 } },                                   // 0xA6 '|'
+  { 4, { 102, 137, 149, 106 } },                    // 0xA7 'Section sign'
+  { 3, {   1,   0,   1 } },                         // 0xA8 'Spacing diaresis'
+  { 7, {  62,  65,  93,  85,  85,  65,  62 } },     // 0xA9 'Copyright'
+  { 3, {  13,  13,  15 } },                         // 0xAA 'Feminine Ordinal Ind.'
+  { 5, {   8,  20,  42,  20,  34 } },               // 0xAB '<<'
+  { 5, {   8,   8,   8,   8,  56 } },               // 0xAC 'Not sign'
+  { 0, {   0 } },                                   // 0xAD 'Soft Hyphen'
+  { 7, {  62,  65, 127,  75, 117,  65,  62 } },     // 0xAE 'Registered Trademark'
+  { 5, {   1,   1,   1,   1,   1 } },               // 0xAF 'Spacing Macron Overline'
+  { 3, {   2,   5,   2 } },                         // 0xB0 'Degree'
+  { 5, {  68,  68,  95,  68,  68 } },               // 0xB1 '+/-'
+  { 3, {  25,  21,  19 } },                         // 0xB2 'Superscript 2'
+  { 3, {  17,  21,  31 } },                         // 0xB3 'Superscript 3'
+  { 2, {   2,   1 } },                              // 0xB4 'Acute accent'
+  { 4, { 252,  64,  64,  60 } },                    // 0xB5 'micro (mu)'
+  { 5, {   6,   9, 127,   1, 127 } },               // 0xB6 'Paragraph Mark'
+  { 2, {  24,  24 } },                              // 0xB7 'Middle Dot'
+  { 3, { 128, 128,  96 } },                         // 0xB8 'Spacing sedilla'
+  { 2, {   2,  31 } },                              // 0xB9 'Superscript 1'
+  { 4, {   6,   9,   9,   6 } },                    // 0xBA 'Masculine Ordinal Ind.'
+  { 5, {  34,  20,  42,  20,   8 } },               // 0xBB '>>'
+  { 6, {  64,  47,  16,  40,  52, 250 } },          // 0xBC '1/4'
+  { 6, {  64,  47,  16, 200, 172, 186 } },          // 0xBD '1/2'
+  { 6, {  85,  53,  31,  40,  52, 250 } },          // 0xBE '3/4'
+  { 5, {  48,  72,  77,  64,  32 } },               // 0xBF 'Inverted ?'
+  { 5, { 120,  20,  21,  22, 120 } },               // 0xC0 'A grave'
+  { 5, { 120,  22,  21,  20, 120 } },               // 0xC1 'A acute'
+  { 5, { 122,  21,  21,  21, 122 } },               // 0xC2 'A circumflex'
+  { 5, { 120,  22,  21,  22, 121 } },               // 0xC3 'A tilde'
+  { 5, { 120,  21,  20,  21, 120 } },               // 0xC4 'A diaresis'
+  { 5, { 120,  20,  21,  20, 120 } },               // 0xC5 'A ring above'
+  { 6, { 124,  10,   9, 127,  73,  73 } },          // 0xC6 'AE'
+  { 5, {  30, 161, 161,  97,  18 } },               // 0xC7 'C sedilla'
+  { 4, { 124,  85,  86,  68 } },                    // 0xC8 'E grave'
+  { 4, { 124,  86,  85,  68 } },                    // 0xC9 'E acute'
+  { 4, { 126,  85,  85,  70 } },                    // 0xCA 'E circumflex'
+  { 4, { 124,  85,  84,  69 } },                    // 0xCB 'E diaresis'
+  { 3, {  68, 125,  70 } },                         // 0xCC 'I grave'
+  { 3, {  68, 126,  69 } },                         // 0xCD 'I acute'
+  { 3, {  70, 125,  70 } },                         // 0xCE 'I circumplex'
+  { 3, {  69, 124,  69 } },                         // 0xCF 'I diaresis'
+  { 6, {   4, 127,  69,  65,  65,  62 } },          // 0xD0 'Capital Eth'
+  { 5, { 124,  10,  17,  34, 125 } },               // 0xD1 'N tilde'
+  { 5, {  56,  68,  69,  70,  56 } },               // 0xD2 'O grave'
+  { 5, {  56,  70,  69,  68,  56 } },               // 0xD3 'O acute'
+  { 5, {  58,  69,  69,  69,  58 } },               // 0xD4 'O circumflex'
+  { 5, {  56,  70,  69,  70,  57 } },               // 0xD5 'O tilde'
+  { 5, {  56,  69,  68,  69,  56 } },               // 0xD6 'O diaresis'
+  { 5, {  34,  20,   8,  20,  34 } },               // 0xD7 'Multiplication sign'
+  { 7, {  64,  62,  81,  73,  69,  62,   1 } },     // 0xD8 'O slashed'
+  { 5, {  60,  65,  66,  64,  60 } },               // 0xD9 'U grave'
+  { 5, {  60,  64,  66,  65,  60 } },               // 0xDA 'U acute'
+  { 5, {  58,  65,  65,  65,  58 } },               // 0xDB 'U circumflex'
+  { 5, {  60,  65,  64,  65,  60 } },               // 0xDC 'U diaresis'
+  { 5, {  12,  16,  98,  17,  12 } },               // 0xDD 'Y acute'
+  { 4, { 127,  18,  18,  12 } },                    // 0xDE 'Capital thorn'
+  { 4, { 254,  37,  37,  26 } },                    // 0xDF 'Small letter sharp S'
+  { 5, {  32,  84,  85, 122,  64 } },               // 0xE0 'a grave'
+  { 5, {  32,  84,  86, 121,  64 } },               // 0xE1 'a acute'
+  { 5, {  34,  85,  85, 121,  66 } },               // 0xE2 'a circumflex'
+  { 5, {  32,  86,  85, 122,  65 } },               // 0xE3 'a tilde'
+  { 5, {  32,  85,  84, 121,  64 } },               // 0xE4 'a diaresis'
+  { 5, {  32,  84,  85, 120,  64 } },               // 0xE5 'a ring above'
+  { 7, {  32,  84,  84, 124,  84,  84,   8 } },     // 0xE6 'ae'
+  { 5, {  24,  36, 164, 228,  40 } },               // 0xE7 'c sedilla'
+  { 5, {  56,  84,  85,  86,  88 } },               // 0xE8 'e grave'
+  { 5, {  56,  84,  86,  85,  88 } },               // 0xE9 'e acute'
+  { 5, {  58,  85,  85,  85,  90 } },               // 0xEA 'e circumflex'
+  { 5, {  56,  85,  84,  85,  88 } },               // 0xEB 'e diaresis'
+  { 3, {  68, 125,  66 } },                         // 0xEC 'i grave'
+  { 3, {  68, 126,  65 } },                         // 0xED 'i acute'
+  { 3, {  70, 125,  66 } },                         // 0xEE 'i circumflex'
+  { 3, {  69, 124,  65 } },                         // 0xEF 'i diaresis'
+  { 4, {  48,  75,  74,  61 } },                    // 0xF0 'Small eth'
+  { 4, { 122,   9,  10, 113 } },                    // 0xF1 'n tilde'
+  { 5, {  56,  68,  69,  70,  56 } },               // 0xF2 'o grave'
+  { 5, {  56,  70,  69,  68,  56 } },               // 0xF3 'o acute'
+  { 5, {  58,  69,  69,  69,  58 } },               // 0xF4 'o circumflex'
+  { 5, {  56,  70,  69,  70,  57 } },               // 0xF5 'o tilde'
+  { 5, {  56,  69,  68,  69,  56 } },               // 0xF6 'o diaresis'
+  { 5, {   8,   8,  42,   8,   8 } },               // 0xF7 'Division sign'
+  { 6, {  64,  56,  84,  76,  68,  58 } },          // 0xF8 'o slashed'
+  { 5, {  60,  65,  66,  32, 124 } },               // 0xF9 'u grave'
+  { 5, {  60,  64,  66,  33, 124 } },               // 0xFA 'u acute'
+  { 5, {  58,  65,  65,  33, 122 } },               // 0xFB 'u circumflex'
+  { 5, {  60,  65,  64,  33, 124 } },               // 0xFC 'u diaresis'
+  { 4, { 156, 162, 161, 124 } },                    // 0xFD 'y acute'
+  { 4, { 252,  72,  72,  48 } },                    // 0xFE 'small thorn'
+  { 4, { 157, 160, 160, 125 } },                    // 0xFF 'y diaresis'
+};
+
+// Glyph for a (Unicode) code point. A character outside the code page gets
+// the glyph of its plain ASCII letter when there is one (like 'c' for 'č').
+inline const NeoGlyph& neoGlyph(uint16_t codePoint)
+{
+  if (codePoint >= NEO_FONT_FIRST && codePoint <= NEO_FONT_LAST) return neoFont[codePoint - NEO_FONT_FIRST];
+
+  uint8_t c = cp1252FromUnicode(codePoint);
+  if (c >= NEO_FONT_CP_FIRST) return neoFontCodePage[c - NEO_FONT_CP_FIRST];
+
+  char fold[4];
+  if (asciiFold(codePoint, fold) && fold[0] >= NEO_FONT_FIRST && fold[0] <= NEO_FONT_LAST && fold[1] == '\0')
+  {
+    return neoFont[fold[0] - NEO_FONT_FIRST];
+  }
+  return neoFont[NEO_FONT_UNKNOWN - NEO_FONT_FIRST];
+}
+
+// Number of columns a code point takes, without the spacing
+inline uint8_t neoGlyphWidth(uint16_t codePoint)
+{
+  return neoGlyph(codePoint).width;
+}
+
+
+// Unicode of the code page 437 characters 0x80..0xFF of the classic font,
+// 0 = box drawing or not used for text
+static constexpr uint16_t neoClassicCodePage[128] =
+{
+  0x00C7, 0x00FC, 0x00E9, 0x00E2, 0x00E4, 0x00E0, 0x00E5, 0x00E7,   // 0x80  Ç ü é â ä à å ç
+  0x00EA, 0x00EB, 0x00E8, 0x00EF, 0x00EE, 0x00EC, 0x00C4, 0x00C5,   // 0x88  ê ë è ï î ì Ä Å
+  0x00C9, 0x00E6, 0x00C6, 0x00F4, 0x00F6, 0x00F2, 0x00FB, 0x00F9,   // 0x90  É æ Æ ô ö ò û ù
+  0x00FF, 0x00D6, 0x00DC, 0x00A2, 0x00A3, 0x00A5, 0x20A7, 0x0192,   // 0x98  ÿ Ö Ü ¢ £ ¥ ₧ ƒ
+  0x00E1, 0x00ED, 0x00F3, 0x00FA, 0x00F1, 0x00D1, 0x00AA, 0x00BA,   // 0xA0  á í ó ú ñ Ñ ª º
+  0x00BF, 0x2310, 0x00AC, 0x00BD, 0x00BC, 0x00A1, 0x00AB, 0x00BB,   // 0xA8  ¿ ⌐ ¬ ½ ¼ ¡ « »
+       0,      0,      0,      0,      0,      0,      0,      0,   // 0xB0  box drawing
+       0,      0,      0,      0,      0,      0,      0,      0,
+       0,      0,      0,      0,      0,      0,      0,      0,   // 0xC0
+       0,      0,      0,      0,      0,      0,      0,      0,
+       0,      0,      0,      0,      0,      0,      0,      0,   // 0xD0
+       0,      0,      0,      0,      0,      0,      0,      0,
+  0x03B1, 0x00DF, 0x0393, 0x03C0, 0x03A3, 0x03C3, 0x00B5, 0x03C4,   // 0xE0  α ß Γ π Σ σ µ τ
+  0x03A6, 0x0398, 0x03A9, 0x03B4, 0x221E, 0x03C6, 0x03B5, 0x2229,   // 0xE8  Φ Θ Ω δ ∞ φ ε ∩
+  0x2261, 0x00B1, 0x2265, 0x2264, 0x2320, 0x2321, 0x00F7, 0x2248,   // 0xF0  ≡ ± ≥ ≤ ⌠ ⌡ ÷ ≈
+  0x00B0, 0x2219, 0x00B7, 0x221A, 0x207F, 0x00B2, 0x25A0, 0x00A0    // 0xF8  ° ∙ · √ ⁿ ² ■ nbsp
+};
+
+// Character of the classic font for a (Unicode) code point. A character it
+// does not have gets its plain ASCII letter when there is one (like 'E' for 'Ê').
+inline uint8_t neoClassicChar(uint16_t codePoint)
+{
+  if (codePoint >= NEO_FONT_FIRST && codePoint <= NEO_FONT_LAST) return (uint8_t)codePoint;
+
+  for (uint8_t i = 0; i < 128; i++)
+  {
+    if (neoClassicCodePage[i] == codePoint) return 0x80 + i;
+  }
+
+  char fold[4];
+  if (asciiFold(codePoint, fold) && fold[0] >= NEO_FONT_FIRST && fold[0] <= NEO_FONT_LAST && fold[1] == '\0')
+  {
+    return (uint8_t)fold[0];
+  }
+  return NEO_FONT_UNKNOWN;
+}
+
+// The NEO_CLASSIC_WIDTH columns of a character of the classic font
+inline const uint8_t* neoClassicGlyph(uint8_t c)
+{
+  return &font[c * NEO_CLASSIC_WIDTH];
+}
@@ -2,12 +2,26 @@
 #include <MD_Parola.h>
 #include <MD_MAX72xx.h>
 #include "BigFont.h" // dubbel hoog font
+#include "WeatherSprites.h"
+#include "FrameStats.h"
+#include "VirtualMatrix.h"
 #include <SPI.h>
 #include <vector>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
 
 #define ZONE_UPPER  1
 #define ZONE_LOWER  0
 
+#define WEATHER_ICON_CHAR  0x01   // user characters 0x01.. (upper zone 0x81..) are the weather sprites
+
+#ifndef MAX_ZONES
+  #define MAX_ZONES  32   // most modules (and so zones) on one chain
+#endif
+#define PAROLA_ZONE_TEXT   256   // bytes of a zone text (UTF-8), longer texts are cut
+#define PAROLA_ZONE_DWELL 1000   // ms a zone text that fits stands still when staticDwellMs is 0
+
 // Configuration structure for Parola display
 struct PAROLA
 {
@@ -17,6 +31,16 @@ struct PAROLA
     uint8_t MY_MAX_SPEED;      // Animation speed (lower = faster)
 };
 
+// A zone with texts of its own (see setZones()): modules firstDevice ..
+// lastDevice, its own speed and exit effects
+struct ParolaZone
+{
+    uint8_t firstDevice;
+    uint8_t lastDevice;
+    int16_t speed;                  // 0 .. 100, like setScrollSpeed()
+    std::vector<uint8_t> effects;   // empty = the setRandomEffects() list
+};
+
 // Display configuration for text animation
 struct DisplayConfig
 {
@@ -33,13 +57,16 @@ class ParolaClass
     ~ParolaClass();
     
     // Initialization
+    void setZones(const std::vector<ParolaZone> &zones);
     bool begin(uint8_t dataPin, uint8_t clkPin, uint8_t csPin, const PAROLA &config);
     
     // Configuration methods
     void setRandomEffects(const std::vector<uint8_t> &effects);
     void setCallback(std::function<void(const std::string&)> callback);
+    void setFrameSink(VirtualMatrix::Sink sink) { frameSink = sink; }
     void setDisplayConfig(const DisplayConfig &config);
-    void tickerClear() { parola->displayClear(); }
+    void setStaticDwell(uint32_t milliSeconds) { staticDwellMs = milliSeconds; }
+    void tickerClear();
     void setScrollSpeed(int16_t speed);
     void setIntensity(int16_t intensity);
     void setColor(int r, int g, int b) { return; }
@@ -47,12 +74,22 @@ class ParolaClass
     
     // Operation methods
     bool sendNextText(const std::string &text);
+    bool sendZoneText(uint8_t zone, const char* text);
+    void setZoneCallback(uint8_t zone, std::function<void(uint8_t, const char*)> callback);
+    uint8_t getZoneCount() const { return zones.size(); }
+    uint16_t measureText(const std::string &text);
     // Blocking fixed animation method (right to left)
     bool animateBlocking(const String &text);
     void loop();
+    bool startRenderTask(uint8_t core = 1);
+    void stopRenderTask();
     
     // Status methods
     bool isInitialized() const { return initialized; }
+#ifdef FRAME_STATS
+    const FrameStats& getFrameStats() const { return frameStats; }
+    void resetFrameStats() { frameStats.reset(); }
+#endif
     
   private:
     // Hardware configuration
@@ -61,6 +98,8 @@ class ParolaClass
     uint8_t dataPin = 0;
     uint8_t clkPin = 0;
     uint8_t numZones = 1;  // Default to 1 zone
+    uint16_t zoneColumns = 0;  // Columns of the (lower) zone
+    bool bigFont = false;      // two zones above each other show one text in the double height font
 
     bool initialized = false;
     bool spiInitialized = false;
@@ -68,11 +107,64 @@ class ParolaClass
     // Display configuration
     std::vector<uint8_t> effectList;
     DisplayConfig displayConfig = {50, 1000, PA_CENTER};
+    uint32_t staticDwellMs = 0;  // a text that fits stands still this long, 0 = every text scrolls
     
     // State tracking
     std::string currentText = "";
     std::function<void(const std::string&)> onFinished = nullptr;
+#ifdef FRAME_STATS
+    FrameStats frameStats;
+#endif
+    
+    // Copy of every changed frame, only when a sink is set
+    VirtualMatrix virtualMatrix;
+    VirtualMatrix::Sink frameSink = nullptr;
+    uint32_t lastFrameHash = 0;
     std::string upperZoneText; // For storing the high-bit version of text
+    std::string shownText;     // currentText in the characters of the font (prepareText())
+    
+    // Zones of setZones(): zone 0 shows the texts of sendNextText(), the others
+    // animate on their own with the texts of sendZoneText() and tell their own
+    // callback when they are done. The buffers are allocated once, in begin().
+    struct ZoneState
+    {
+      ParolaZone config;
+      uint16_t columns;
+      uint16_t speed;                  // MD_Parola frame delay
+      char pending[PAROLA_ZONE_TEXT];  // sent, not started yet (written under zoneMux)
+      char text[PAROLA_ZONE_TEXT];     // UTF-8, as sent
+      char shown[PAROLA_ZONE_TEXT];    // in the characters of the font, MD_Parola points to it
+      bool animating;
+      volatile bool finishedPending;   // done, onFinished() not yet called (render task)
+      std::function<void(uint8_t, const char*)> onFinished;
+    };
+    std::vector<ParolaZone> zoneConfig;  // from setZones(), begin() sets them up
+    std::vector<ZoneState> zones;        // empty: one text on all zones
+    std::string preparedText;            // prepareText() output for a zone, keeps its capacity
+    portMUX_TYPE zoneMux = portMUX_INITIALIZER_UNLOCKED;
+    
+    // Weather sprites as Parola user characters: width + columns, twice as
+    // big for the two zone (double height) font. Parola keeps the pointers.
+    uint8_t weatherChars[WEATHER_SPRITES][2][1 + 2 * WEATHER_SPRITE_WIDTH];
+    
+    // Columns of every character of the (lower) zone font. measureText() runs
+    // on other tasks and must not touch MD_Parola, its glyph buffer belongs to
+    // the render task.
+    uint8_t charColumns[256];
+    
+    // Render task: owns the display once started, the other tasks post commands
+    struct RenderCommand
+    {
+      uint8_t type;
+      int16_t value;
+      char*   text;     // strdup()'d by the sender, freed by the render task
+    };
+    TaskHandle_t  renderTaskHandle = nullptr;
+    QueueHandle_t renderQueue = nullptr;
+    volatile bool renderTaskRunning = false;
+    volatile bool finishedPending = false;  // Animation done, onFinished() not yet called
+    bool          animationDone = false;    // displayAnimate() completed for currentText
+    std::string   finishedText;
     
     // Debug support
     Stream* debug = nullptr;
@@ -83,7 +175,20 @@ class ParolaClass
     void cleanup();
     int16_t scaleValue(int16_t input, int16_t minInValue, int16_t maxInValue, int16_t minOutValue, int16_t maxOutValue);
     textEffect_t getRandomEffect();
+    textEffect_t getRandomEffect(const std::vector<uint8_t> &effects);
+    bool setupZones(uint8_t numDevices);
+    void startZoneText(uint8_t zone);
+    bool animate(bool triggerCallbacks);
     const char* setHighBits(const std::string &text);
+    void addWeatherChars();
+    void loadCharColumns(const uint8_t* font);
+    void prepareText(const char* text, std::string &result);
+    void captureFrame();
+    bool postCommand(uint8_t type, int16_t value = 0, const char* text = nullptr);
+    bool inRenderTask() const;
+    void handleCommand(RenderCommand &command);
+    void renderLoop();
+    static void renderTask(void* parameter);
 
 
   #ifdef PAROLA_DEBUG
@@ -5,24 +5,41 @@
 #include <WiFiClientSecure.h>
 #include <vector>
 #include <ctime>
+#include <functional>
 
 class RSSreaderClass {
 public:
+  //-- read position of a reader that has its own rotation through the feeds
+  struct ReadCursor {
+    uint8_t feedIndex = 0;
+    size_t  itemIndices[10] = {0};
+  };
+
   RSSreaderClass();
 
   void          loop(struct tm timeNow); 
   void          setDebug(Stream* debugPort) { debug = debugPort; }
   void          setRequestInterval(uint32_t interval) { _interval = interval * 60 * 1000; }
-  bool          addRSSfeed(const char* url, const char* path, size_t maxFeeds);
+  void          setStorageBudget(size_t bytes) { _storageBudget = bytes; }
+  bool          addRSSfeed(const char* url, const char* path, size_t weight);
   bool          getNextFeedItem(uint8_t& feedIndex, size_t& itemIndex);
+  bool          getNextFeedItem(ReadCursor& cursor, uint8_t& feedIndex, size_t& itemIndex);
   String        readRSSfeed(uint8_t feedIndex, size_t itemIndex);
   String        checkFeedHealth(uint8_t feedNr = 0);
   void          checkAllFeedsHealth();
   void          addToSkipWords(std::string noNoWord);
   void          addWordStringToSkipWords(std::string wordList);
   void          readSkipWordsFromFile();
+  void          setHeadlineWidth(uint16_t pixels) { _headlineWidth = pixels; }
+  void          setTextMeasure(std::function<uint16_t(const String&)> measure) { _measureText = measure; }
+  void          addWordStringToAbbreviations(std::string wordList);
+  void          readAbbreviationsFromFile();
+  String        fitHeadline(const String& title);
   String        simplifyCharacters(const String& input);
   uint8_t       getActiveFeedCount(int8_t feedNr = 0) { return _actFeedsPerFile[feedNr]; }
+  size_t        getFeedBytes(uint8_t feedNr) { return _bytesPerFile[feedNr]; }
+  size_t        getFeedByteShare(uint8_t feedNr);
+  uint16_t      getRedirectCount(uint8_t feedNr) { return _redirectCounts[feedNr]; }
 
 private:
   struct FeedItem {
@@ -35,8 +52,10 @@ private:
   String        _paths[10];
   String        _filePaths[10];
   uint8_t       _activeFeedCount = 0;
-  size_t        _maxFeedsPerFile[10] = {0};
+  size_t        _feedWeights[10] = {0};   // Share of the storage budget per feed
   size_t        _actFeedsPerFile[10] = {0};
+  size_t        _bytesPerFile[10] = {0};  // Actual bytes stored per feed
+  size_t        _storageBudget = 65536;   // Bytes for all feed files together
   uint32_t      _interval = 12000000; // standaard 20 min
   uint32_t      _lastCheck = 0;
   void          createRSSfeedFolder();
@@ -48,19 +67,39 @@ private:
   uint8_t       _currentItemIndex = 0;
   size_t        _currentItemIndices[10] = {0}; // Track current item index for each feed
   uint8_t       _feedReadCounts[10] = {0}; // Track how many items we've read from each feed
-  uint16_t      _totalMaxFeeds = 0;       // Sum of all maxFeeds values
+  uint16_t      _totalWeight = 0;         // Sum of all feed weights
   uint32_t      _lastHealthCheck = 0;
   const uint32_t _healthCheckInterval = 60 * 60 * 1000; // one hour
   uint32_t      _lastFeedUpdate[10] = {0}; // Track when each feed was last updated
+  String        _redirectHosts[10];        // Cached permanent (301) target per feed
+  String        _redirectPaths[10];
+  bool          _redirectSecure[10] = {false};
+  uint16_t      _redirectCounts[10] = {0}; // Redirects followed per feed
   std::vector<std::string> _skipWords;
+  std::vector<std::pair<std::string, std::string>> _abbreviations; // word -> abbreviation
+  uint16_t      _headlineWidth = 0;      // Pixel budget for a headline (0 = no fitting)
+  std::function<uint16_t(const String&)> _measureText = nullptr;
   bool          hasSufficientWords(const String& title);
   bool          hasNoSkipWords(const String& title);
+  bool          headlineFits(const String& title);
+  bool          dropBracketedSuffix(String& title);
+  bool          dropSourceSuffix(String& title);
+  bool          abbreviateWord(String& title, const std::string& word, const std::string& abbreviation);
 
-  String        fetchFeed(const char* host, const char* path);
+  String        fetchFeed(uint8_t feedIndex);
+  String        httpGet(const String& host, const String& path, bool secure, int& status, String& location);
+  bool          splitLocation(const String& location, String& host, String& path, bool& secure);
+  String        redirectFilePath(uint8_t feedIndex);
+  void          loadRedirect(uint8_t feedIndex);
+  void          saveRedirect(uint8_t feedIndex, const String& host, const String& path, bool secure);
+  void          forgetRedirect(uint8_t feedIndex);
   std::vector<String> extractTitles(const String& feed);
   std::vector<String> getStoredLines(uint8_t feedIndex);
   void          saveTitles(const std::vector<String>& titles, uint8_t feedIndex);
   bool          titleExists(const String& title, const std::vector<String>& lines);
+  size_t        selectWithinShare(const std::vector<String>& lines, const std::vector<time_t>& dates
+                                  , size_t share, std::vector<bool>& keep);
+  void          enforceFeedShare(uint8_t feedIndex);
   ;void         checkForNewFeedItems();
   void          checkFeed(uint8_t feedIndex);
   std::vector<FeedItem> extractFeedItems(const String& feed);
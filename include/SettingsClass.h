@@ -123,6 +123,9 @@ public:
   int16_t devLDRMaxWaarde;
   int16_t devMaxIntensiteitLeds;
   std::string devSkipWords;
+  int16_t devHeadlineWidth;
+  std::string devAbbreviations;
+  int16_t devStaticDwell = 0;   // seconds a short text stands still, 0 = scroll
   int16_t devResetWiFiPin;
   int16_t devTickerSpeed;
   bool    devShowLocalA;
@@ -149,6 +152,7 @@ public:
   int16_t parolaPinDIN;
   int16_t parolaPinCS;
   int16_t parolaPinCLK;
+  std::string parolaZones;      // zones of their own: "first-last,source,speed[,effects];..", empty = parolaNumZones
 #endif
 
 #ifdef USE_NEOPIXELS
@@ -157,16 +161,29 @@ public:
   int16_t neopixWidth;
   int16_t neopixHeight;
   int16_t neopixPixPerChar;
+  bool neopixPropFont = false;  // proportional (ExtASCII) font instead of the classic 5x7 font
   int16_t neopixCOLOR;
   bool neopixFREQ;
   bool neopixMATRIXTYPEV;
   bool neopixMATRIXTYPEH;
   bool neopixMATRIXORDER;
   bool neopixMATRIXSEQUENCE;
+  int16_t neopixGAMMA = 26;     // gamma * 10
+  bool neopixDITHER = false;
+  bool neopixSubPixel = false;  // blend the text between two pixel steps
+  int16_t neopixPanels = 1;     // panels of neopixWidth x neopixHeight side by side
+  std::string neopixPanelPins;  // data pins of the panels, empty = all on neopixDataPin
+  int16_t neopixMaxMA = 0;      // power budget of the LEDs in mA, 0 = none
+  int16_t neopixClockWidth = 0; // columns of the clock left of the ticker, 0 = no clock
+  std::string neopixClockColor = "200,200,200";  // "R,G,B" of the clock
+  int16_t neopixRows = 1;       // ticker rows above each other (2 needs a height of 16)
+  int16_t neopixRowSource = 0;  // text of the second row: 0 = weerlive, 1 = rssfeed
+  int16_t neopixRowSpeed = 50;  // speed of the second row, like devTickerSpeed
 #endif
 
   // rssfeed settings data
   int16_t requestInterval = 60; // Default request interval in minutes
+  int16_t storageBudget = 64;   // KB on LittleFS shared by all feeds (by weight)
   std::string domain0 = {};
   std::string path0  = {};
   int16_t maxFeeds0 = 0;
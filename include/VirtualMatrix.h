@@ -0,0 +1,92 @@
+#ifndef VIRTUAL_MATRIX_H
+#define VIRTUAL_MATRIX_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+#include <algorithm>
+#include <functional>
+
+//-- RGB image of what the display shows. The display classes fill it for
+//-- every frame when a frame sink is set (setFrameSink()), so frames can be
+//-- hashed or written as PPM files without LEDs, e.g. in a host build.
+
+class VirtualMatrix
+{
+public:
+  typedef std::function<void(const VirtualMatrix&)> Sink;
+
+  void resize(uint16_t newWidth, uint16_t newHeight)
+  {
+    width  = newWidth;
+    height = newHeight;
+    pixels.assign((size_t)width * height * 3, 0);
+  }
+
+  void clear() { std::fill(pixels.begin(), pixels.end(), 0); }
+
+  void setPixel(uint16_t x, uint16_t y, uint8_t r, uint8_t g, uint8_t b)
+  {
+    if (x >= width || y >= height) return;
+    uint8_t* p = &pixels[((size_t)y * width + x) * 3];
+    p[0] = r;
+    p[1] = g;
+    p[2] = b;
+  }
+
+  uint16_t getWidth() const  { return width; }
+  uint16_t getHeight() const { return height; }
+  const std::vector<uint8_t>& getPixels() const { return pixels; }
+
+  // FNV-1a over the size and the RGB bytes, equal frames give equal hashes
+  uint32_t hash() const
+  {
+    uint32_t h = 2166136261u;
+    const uint8_t size[4] = {(uint8_t)(width >> 8), (uint8_t)width, (uint8_t)(height >> 8), (uint8_t)height};
+    for (uint8_t c : size)   h = (h ^ c) * 16777619u;
+    for (uint8_t c : pixels) h = (h ^ c) * 16777619u;
+    return h;
+  }
+
+  // Binary PPM (P6), every LED 'scale' x 'scale' image pixels
+  bool writePPM(const char* path, uint8_t scale = 1) const
+  {
+    if (scale == 0) scale = 1;
+    FILE* file = fopen(path, "wb");
+    if (file == nullptr) return false;
+
+    fprintf(file, "P6\n%u %u\n255\n", (unsigned)width * scale, (unsigned)height * scale);
+    std::vector<uint8_t> line((size_t)width * scale * 3);
+    for (uint16_t y = 0; y < height; y++)
+    {
+      for (uint16_t x = 0; x < width; x++)
+      {
+        for (uint8_t s = 0; s < scale; s++)
+        {
+          const uint8_t* p = &pixels[((size_t)y * width + x) * 3];
+          uint8_t* q = &line[((size_t)x * scale + s) * 3];
+          q[0] = p[0];
+          q[1] = p[1];
+          q[2] = p[2];
+        }
+      }
+      for (uint8_t s = 0; s < scale; s++) fwrite(line.data(), 1, line.size(), file);
+    }
+    return fclose(file) == 0;
+  }
+
+  // Write frame 'number' with a printf() pattern like "frames/f%05u.ppm"
+  bool writeFrame(const char* pattern, uint32_t number, uint8_t scale = 1) const
+  {
+    char path[128];
+    snprintf(path, sizeof(path), pattern, (unsigned)number);
+    return writePPM(path, scale);
+  }
+
+private:
+  uint16_t width  = 0;
+  uint16_t height = 0;
+  std::vector<uint8_t> pixels;   // RGB, row by row
+};
+
+#endif // VIRTUAL_MATRIX_H
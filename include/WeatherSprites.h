@@ -0,0 +1,196 @@
+/*
+**  WeatherSprites.h
+**
+**  8x8 weather icons for the Weerlive "image" field. A weather text marks an
+**  icon as "{name}" (printable, so it survives simplifyCharacters()), the
+**  display classes put the sprite in its place.
+**
+**  The sprites are stored packed in flash: width, a mask with a bit set for
+**  every column that repeats the column left of it, then only the other
+**  columns (bit0 = top row). They are unpacked once, on first use, into
+**  weatherSprites() so drawing them costs no more than drawing a glyph.
+*/
+#pragma once
+#include <Arduino.h>
+
+#define WEATHER_SPRITE_HEIGHT   8
+#define WEATHER_SPRITE_WIDTH    8   // widest sprite in columns
+#define WEATHER_ICON_OPEN     '{'
+#define WEATHER_ICON_CLOSE    '}'
+#define WEATHER_ICON_MAX_NAME  20   // longest name between the braces
+
+#define WEATHER_SPRITE_ZON         0
+#define WEATHER_SPRITE_WOLK        1
+#define WEATHER_SPRITE_ZON_WOLK    2
+#define WEATHER_SPRITE_REGEN       3
+#define WEATHER_SPRITE_ONWEER      4
+#define WEATHER_SPRITE_SNEEUW      5
+#define WEATHER_SPRITE_MIST        6
+#define WEATHER_SPRITE_MAAN        7
+#define WEATHER_SPRITES            8
+
+static const uint8_t weatherSpriteData[] PROGMEM =
+{
+  // zon
+  //      #
+  //    #   #
+  //     ###
+  //   # ### #
+  //     ###
+  //    #   #
+  //      #
+  //
+  7, 0x00, 8, 34, 28, 93, 28, 34, 8,
+  // wolk
+  //
+  //      ##
+  //     #  ##
+  //    #     #
+  //   #      #
+  //   #      #
+  //    ######
+  //
+  8, 0x50, 48, 72, 68, 66, 68, 56,
+  // zon en wolk
+  //   # #
+  //    #
+  //   # # ##
+  //     #  ##
+  //    #     #
+  //   #      #
+  //    ######
+  //
+  8, 0x00, 37, 82, 77, 64, 68, 76, 72, 48,
+  // regen
+  //      ##
+  //     #  ##
+  //    #     #
+  //    ######
+  //
+  //    #  #  #
+  //   #  #  #
+  //
+  8, 0x00, 64, 44, 10, 73, 41, 10, 74, 36,
+  // onweer
+  //     ##
+  //    #  ##
+  //   #     #
+  //   ## ###
+  //     #
+  //    ##
+  //     #
+  //    #
+  7, 0x20, 12, 170, 113, 9, 10, 4,
+  // sneeuw
+  //   #  #  #
+  //    # # #
+  //     ###
+  //   #######
+  //     ###
+  //    # # #
+  //   #  #  #
+  //
+  7, 0x00, 73, 42, 28, 127, 28, 42, 73,
+  // mist
+  //
+  //   #######
+  //
+  //    #######
+  //
+  //   #######
+  //
+  //    #######
+  8, 0x7C, 34, 170, 136,
+  // maan
+  //     ###
+  //    ##
+  //   ##
+  //   ##
+  //   ##
+  //    ##
+  //     ###
+  //
+  5, 0x10, 28, 62, 99, 65,
+};
+
+struct WeatherSprite
+{
+  uint8_t width;                          // number of columns
+  uint8_t columns[WEATHER_SPRITE_WIDTH];  // bit0 = top row
+};
+
+// Weerlive image names and the sprite that goes with them
+struct WeatherIconName
+{
+  const char* name;
+  uint8_t     sprite;
+};
+
+static const WeatherIconName weatherIconNames[] =
+{
+  { "zonnig",            WEATHER_SPRITE_ZON      },
+  { "bewolkt",           WEATHER_SPRITE_WOLK     },
+  { "zwaarbewolkt",      WEATHER_SPRITE_WOLK     },
+  { "wolkennacht",       WEATHER_SPRITE_WOLK     },
+  { "lichtbewolkt",      WEATHER_SPRITE_ZON_WOLK },
+  { "halfbewolkt",       WEATHER_SPRITE_ZON_WOLK },
+  { "regen",             WEATHER_SPRITE_REGEN    },
+  { "buien",             WEATHER_SPRITE_REGEN    },
+  { "halfbewolkt_regen", WEATHER_SPRITE_REGEN    },
+  { "bliksem",           WEATHER_SPRITE_ONWEER   },
+  { "sneeuw",            WEATHER_SPRITE_SNEEUW   },
+  { "hagel",             WEATHER_SPRITE_SNEEUW   },
+  { "mist",              WEATHER_SPRITE_MIST     },
+  { "nachtmist",         WEATHER_SPRITE_MIST     },
+  { "helderenacht",      WEATHER_SPRITE_MAAN     },
+  { "nachtbewolkt",      WEATHER_SPRITE_MAAN     },
+};
+
+// The unpacked sprites, decoded from flash the first time they are needed
+inline const WeatherSprite* weatherSprites()
+{
+  struct Cache
+  {
+    WeatherSprite sprite[WEATHER_SPRITES];
+    Cache()
+    {
+      const uint8_t* p = weatherSpriteData;
+      for (uint8_t s = 0; s < WEATHER_SPRITES; s++)
+      {
+        uint8_t width   = pgm_read_byte(p++);
+        uint8_t repeats = pgm_read_byte(p++);
+        sprite[s].width = width;
+        for (uint8_t c = 0; c < width; c++)
+        {
+          sprite[s].columns[c] = (repeats & (1 << c)) ? sprite[s].columns[c - 1] : pgm_read_byte(p++);
+        }
+      }
+    }
+  };
+  static const Cache cache;
+  return cache.sprite;
+}
+
+// Sprite number for an image name, -1 if there is none
+inline int8_t weatherSpriteIndex(const char* name, size_t length)
+{
+  for (const WeatherIconName& icon : weatherIconNames)
+  {
+    if (strlen(icon.name) == length && strncmp(icon.name, name, length) == 0) return icon.sprite;
+  }
+  return -1;
+}
+
+// If 'text' starts with "{name}" of a known icon: the sprite number and in
+// 'length' the number of characters of the marker. Otherwise -1.
+inline int8_t weatherIconAt(const char* text, size_t& length)
+{
+  if (*text != WEATHER_ICON_OPEN) return -1;
+  const char* close = text + 1;
+  while (*close && *close != WEATHER_ICON_CLOSE && close - text <= WEATHER_ICON_MAX_NAME) close++;
+  if (*close != WEATHER_ICON_CLOSE) return -1;
+
+  int8_t sprite = weatherSpriteIndex(text + 1, close - text - 1);
+  if (sprite >= 0) length = close - text + 1;
+  return sprite;
+}
@@ -36,6 +36,7 @@ private:
     uint32_t            requestInterval = 0;
     uint32_t            loopTimer = 0;
     const char*         dateToDayName(const char* date_str);
+    String              imageText(const String& image);
     Stream* debug = nullptr; // Optional, default to nullptr
 
 
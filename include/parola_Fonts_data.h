@@ -130,7 +130,7 @@ MD_MAX72XX::fontType_t ExtASCII[] PROGMEM =
   1, 119,                     // 124 - '|'
   3, 65, 54, 8,               // 125 - '}'
   5, 2, 1, 2, 4, 2,           // 126 - '~'
-  0,                          // 127 - 'Unused'
+  5, 255, 255, 255, 255, 255, // 127 - 'Full block' (<pixeltest>)
   6, 20, 62, 85, 85, 65, 34,  // 128 - 'Euro sign'
   0,                          // 129 - 'Not used'
   2, 128, 96,                 // 130 - 'Single low 9 quotation mark'
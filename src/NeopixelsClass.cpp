@@ -1,4 +1,58 @@
 #include "NeopixelsClass.h"
+#include "NeopixelsFont.h"
+#include "NeopixelsEncoder.h"
+#include "WeatherSprites.h"
+#include <algorithm>
+#include <math.h>
+
+#define SHIFT_PIXELS  0   // no regular pattern, move pixel by pixel via pixelMap
+#define SHIFT_ROWS    1   // every row is a contiguous run in the buffer (ROWS layout)
+#define SHIFT_BLOCK   2   // columns are contiguous and in order (COLUMNS, PROGRESSIVE)
+
+#define RENDER_TEXT        0   // commands for the render task
+#define RENDER_COLOR       1
+#define RENDER_INTENSITY   2
+#define RENDER_SPEED       3
+#define RENDER_CLEAR       4
+#define RENDER_STOP        5
+#define RENDER_STATIC      6
+#define RENDER_OVERLAY     7
+#define RENDER_ROWS        8
+#define RENDER_ROW_TEXT    9
+#define RENDER_ROW_SPEED  10
+
+#define RENDER_QUEUE_LENGTH   8
+#define RENDER_TASK_STACK  4096
+#define RENDER_TASK_PRIORITY  5   // above the Arduino loop() task (1)
+
+#define NEO_MA_PER_CHANNEL   20   // mA of one colour of a LED at 255
+#define NEO_MA_IDLE           1   // mA of a LED that is off
+
+#define NEO_RMT_CHANNELS      8   // channels (and 64 symbol memory blocks) of the ESP32
+#define NEO_RMT_MEM_BLOCKS    4   // 256 symbols, the interrupt refills 128 at a time
+#define NEO_RMT_MIN_BLOCKS    2   // less leaves the interrupt no time to refill (see beginRmtOutput())
+#define NEO_RMT_MAX_PINS     (NEO_RMT_CHANNELS / NEO_RMT_MIN_BLOCKS)
+
+#if ESP_IDF_VERSION_MAJOR < 5
+// RMT translators, called by rmt_write_sample() and then from the RMT interrupt
+// every time half of the channel memory has been sent. The interrupt is in
+// IRAM and runs while the flash is written, so everything it touches is in
+// IRAM or DRAM: neoEncodeBytes() is inlined and the timing is a local copy
+// (its values end up in the code, not in flash constants).
+static void IRAM_ATTR rmtTranslate800(const void* src, rmt_item32_t* dest, size_t srcSize
+                                    , size_t wantedNum, size_t* translatedSize, size_t* itemNum)
+{
+  const NeoBitTiming timing = neoTiming800;
+  *itemNum = neoEncodeBytes((const uint8_t*)src, srcSize, (uint32_t*)dest, wantedNum, timing, *translatedSize);
+}
+
+static void IRAM_ATTR rmtTranslate400(const void* src, rmt_item32_t* dest, size_t srcSize
+                                    , size_t wantedNum, size_t* translatedSize, size_t* itemNum)
+{
+  const NeoBitTiming timing = neoTiming400;
+  *itemNum = neoEncodeBytes((const uint8_t*)src, srcSize, (uint32_t*)dest, wantedNum, timing, *translatedSize);
+}
+#endif
 
 // Constructor implementation
 NeopixelsClass::NeopixelsClass()
@@ -23,7 +77,6 @@ NeopixelsClass::NeopixelsClass()
   lastUpdateTime = 0;
   matrixInitialized = false;
   configInitialized = false;
-  previousText = "";
   readyForNextMessage = false;
   lastStopPosition = 0;
 }
@@ -38,6 +91,9 @@ NeopixelsClass::~NeopixelsClass()
 // Cleanup resources
 void NeopixelsClass::cleanup()
 {
+  stopRenderTask();
+  endRmtOutput();
+  
   if (matrix != nullptr)
   {
     if (debug) debugPrint("NeopixelsClass: Deleting matrix object");
@@ -94,6 +150,23 @@ void NeopixelsClass::setMatrixSize(int width, int height)
   this->height = height;
 }
 
+// Number of panels of width x height side by side, the left one first in the
+// NeoPixel buffer. The panels are divided over pins in order (4 panels on 2
+// pins: 2 chained panels per pin), without pins they are all on one pin.
+void NeopixelsClass::setPanels(int panels, const std::vector<uint8_t>& pins)
+{
+  if (panels < 1 || panels > NEO_MAX_PANELS)
+  {
+    if (debug) debugPrint("NeopixelsClass: Invalid number of panels: %d", panels);
+    return;
+  }
+  
+  if (debug) debugPrint("NeopixelsClass: Setting %d panel(s) on %d pin(s)", panels, std::max(1, (int)pins.size()));
+  
+  this->panels    = panels;
+  this->panelPins = pins;
+}
+
 // Set the number of pixels per character
 void NeopixelsClass::setPixelsPerChar(int pixels)
 {
@@ -135,6 +208,7 @@ void NeopixelsClass::begin(uint8_t pin)
     debugPrint("  neopixelPin       : %d", neopixelPin);
     debugPrint("  Width             : %d", width);
     debugPrint("  Height            : %d", height);
+    debugPrint("  Panels            : %d", panels);
     debugPrint("  Pixel Type        : 0x%02x", (uint32_t)pixelType);
   }
   else
@@ -143,6 +217,7 @@ void NeopixelsClass::begin(uint8_t pin)
     Serial.printf("  neopixelPin       : %d\n", neopixelPin);
     Serial.printf("  Width             : %d\n", width);
     Serial.printf("  Height            : %d\n", height);
+    Serial.printf("  Panels            : %d\n", panels);
     Serial.printf("  Pixel Type        : 0x%02x\n", (uint32_t)pixelType);
   }
   
@@ -157,11 +232,22 @@ void NeopixelsClass::begin(uint8_t pin)
     if (debug)  debugPrint("NeopixelsClass: Combined matrix config: 0x%02x", matrixConfig);
     else     Serial.printf("Combined matrix config: 0x%02x\n", matrixConfig);
     
-    // Create the matrix object with the specified parameters
-    matrix = new Adafruit_NeoMatrix(
-      width, height, neopixelPin,
-      matrixConfig,
-      pixelType);
+    // Create the matrix object with the specified parameters, more panels
+    // are tiles in one row (left to right, every tile with matrixConfig)
+    if (panels > 1)
+    {
+      matrix = new Adafruit_NeoMatrix(
+        width, height, panels, 1, neopixelPin,
+        matrixConfig + NEO_TILE_TOP + NEO_TILE_LEFT + NEO_TILE_ROWS + NEO_TILE_PROGRESSIVE,
+        pixelType);
+    }
+    else
+    {
+      matrix = new Adafruit_NeoMatrix(
+        width, height, neopixelPin,
+        matrixConfig,
+        pixelType);
+    }
     
     if (matrix == nullptr)
     {
@@ -186,20 +272,29 @@ void NeopixelsClass::begin(uint8_t pin)
     matrix->setTextColor(matrix->Color(red, green, blue));
 
     matrix->setBrightness(40);
-    matrix->setTextColor(matrix->Color(0, 255, 0)); // Green
+    textColor = matrix->Color(0, 255, 0); // Green
+    matrix->setTextColor(textColor);
     matrix->setRotation(0);
   
     
-    textScrollPosition = matrix->width(); // Initialize x position
+    buildPixelMap();
+    
+    textScrollPosition = tickerWidth; // Initialize x position
     if (debug)
     {
       debugPrint("NeopixelsClass: Initial x position set to: %d", textScrollPosition);
       debugPrint("NeopixelsClass: Initialization complete");
     }
     
+    // Before the first show(), Adafruit_NeoPixel must not claim the pin itself
+    if (beginRmtOutput())
+    {
+      if (debug) debugPrint("NeopixelsClass: Frames are sent by RMT");
+    }
+    else if (debug) debugPrint("NeopixelsClass: Frames are sent by Adafruit_NeoPixel::show(), all panels on GPIO %d", neopixelPin);
+    
     // Show an initial blank display
-    matrix->fillScreen(0);
-    matrix->show();
+    clearFrame();
     
     matrixInitialized = true;
     configInitialized = true;
@@ -251,6 +346,8 @@ void NeopixelsClass::setColor(int r, int g, int b)
   if (g < 0) g = 0; if (g > 255) g = 255;
   if (b < 0) b = 0; if (b > 255) b = 255;
   
+  if (postCommand(RENDER_COLOR, r, g, b)) return;
+  
   if (doDebug && debug)
   {
     debugPrint("NeopixelsClass: Setting color");
@@ -268,7 +365,9 @@ void NeopixelsClass::setColor(int r, int g, int b)
     try
     {
       if (debug) debugPrint("NeopixelsClass: Applying color to matrix");
-      matrix->setTextColor(matrix->Color(red, green, blue));
+      textColor = matrix->Color(red, green, blue);
+      matrix->setTextColor(textColor);
+      updatePixelBytes();
     }
     catch (...)
     {
@@ -287,6 +386,8 @@ void NeopixelsClass::setIntensity(int newBrightness)
   if (newBrightness < 0)   newBrightness =  10;
   if (newBrightness > 100) newBrightness = 100;
 
+  if (postCommand(RENDER_INTENSITY, newBrightness)) return;
+
   this->brightness = scaleValue(newBrightness, 0, 100, 0, 100);
   
   if (debug)
@@ -300,8 +401,7 @@ void NeopixelsClass::setIntensity(int newBrightness)
     try
     {
       if (debug) debugPrint("NeopixelsClass: Applying brightness to matrix");
-      matrix->setBrightness(brightness);
-      matrix->show(); // Update the display with new brightness
+      sendFrontBuffer(); // levelLut is rebuilt for the new brightness
     }
     catch (...)
     {
@@ -320,6 +420,8 @@ void NeopixelsClass::setScrollSpeed(int newSpeed)
 {
   int tmpScrollDelay = 0;
 
+  if (postCommand(RENDER_SPEED, newSpeed)) return;
+
   tmpScrollDelay = scaleValue(newSpeed, 0, 100, 100, 0);
   if (debug && doDebug)
   {
@@ -349,6 +451,59 @@ void NeopixelsClass::setScrollSpeed(int newSpeed)
 } // setScrollSpeed()
 
 
+// Blank columns after a character: the classic font takes "Pixels per
+// Character" columns for its 5 column glyphs, the proportional font adds one
+int NeopixelsClass::charSpacing()
+{
+  if (proportionalFont) return 1;
+  return std::max(0, pixelPerChar - NEO_CLASSIC_WIDTH);
+
+} // charSpacing()
+
+
+// Glyph of the character at 'p' in the active font, advances 'p' past it.
+// Returns the number of columns of the glyph, without the spacing.
+uint8_t NeopixelsClass::nextGlyph(const char*& p, const uint8_t*& columns)
+{
+  uint16_t codePoint = utf8NextCodePoint(p);
+  if (proportionalFont)
+  {
+    const NeoGlyph& glyph = neoGlyph(codePoint);
+    columns = glyph.columns;
+    return glyph.width;
+  }
+  columns = neoClassicGlyph(neoClassicChar(codePoint));
+  return std::min(pixelPerChar, NEO_CLASSIC_WIDTH);
+
+} // nextGlyph()
+
+
+// Width in pixels of text (UTF-8) as it will be rendered, from the glyph
+// widths of the active font and the weather sprites
+uint16_t NeopixelsClass::measureText(const std::string& text)
+{
+  int spacing = charSpacing();
+  uint16_t textWidth = 0;
+  size_t iconLength;
+  const uint8_t* columns;
+  
+  const char* p = text.c_str();
+  while (*p)
+  {
+    int8_t icon = weatherIconAt(p, iconLength);
+    if (icon >= 0)
+    {
+      textWidth += weatherSprites()[icon].width + spacing;
+      p += iconLength;
+      continue;
+    }
+    textWidth += nextGlyph(p, columns) + spacing;
+  }
+  return textWidth;
+
+} // measureText()
+
+
 // Set the text to be displayed
 void NeopixelsClass::sendNextText(const std::string& newText)
 {
@@ -358,78 +513,52 @@ void NeopixelsClass::sendNextText(const std::string& newText)
     return;
   }
   
+  if (postCommand(RENDER_TEXT, 0, 0, 0, 0, newText.c_str())) return;
+  
   if (debug)
   {
     debugPrint("NeopixelsClass: Setting text to display: '%s'", newText.c_str());
   }
   
-  // If we're ready for the next message (previous message has completed but is still on screen)
-  if (readyForNextMessage)
+  // Text that is leaving with an exit effect is gone at once
+  if (effect != PA_NO_EFFECT)
   {
-    int matrixWidth = matrix->width();
-    
-    // Calculate the position for the new text (at the right edge of the matrix)
-    int newTextX = matrixWidth;
-    
-    // OPTIMIZATION: First trim the existing text, then concatenate
-    trimTextAndRecalculate();
-    this->text = this->text + "*" + newText;
-    
-    // Keep the current position (don't reset it)
-    // The textScrollPosition is already set correctly from the previous animation
-    
-    if (debug)
-    {
-      debugPrint("NeopixelsClass: Adding new text at right edge, combined text is: '%s'", this->text.c_str());
-      debugPrint("NeopixelsClass: Keeping x position at %d", this->textScrollPosition);
-    }
-    
-    // Reset the flag
-    readyForNextMessage = false;
+    stopEffect();
+    clearSegments();
   }
-  // If there's already text being displayed and animation is in progress
-  else if (!previousText.empty() && !textComplete)
+  
+  // A text that fits the display stands still, centred, when it has scrolled in
+  int textWidth = measureText(newText) - charSpacing();
+  bool centred  = (staticDwellMs > 0 && textWidth <= tickerWidth);
+  
+  // While text is scrolling or still on screen the new text is added as a
+  // segment behind it, the position does not change
+  if (segmentCount > 0)
   {
-    // OPTIMIZATION: First trim the previous text, then concatenate
-    std::string tempText = previousText;
-    // We need to temporarily set this->text to previousText to trim it
-    std::string originalText = this->text;
-    this->text = previousText;
-    trimTextAndRecalculate();
-    std::string trimmedPreviousText = this->text;
-    this->text = originalText; // Restore original
-    
-    // Now append the new text to the trimmed previous text
-    this->text = trimmedPreviousText + "*" + newText;
+    appendSegment(centred ? newText : "*" + newText, centred);
     
     if (debug)
     {
-      debugPrint("NeopixelsClass: Appending to previous text, new text is: '%s'", this->text.c_str());
+      debugPrint("NeopixelsClass: Adding new text behind [%d] segment(s), [%d] columns in total", segmentCount - 1, ringWidth);
+      debugPrint("NeopixelsClass: Keeping x position at %d", this->textScrollPosition);
     }
   }
   else
   {
-    // First message or previous message completed, set the text directly
-    this->text = newText;
-    
-    try
-    {
-      this->textScrollPosition = matrix->width(); // Reset position only for new text
-      if (debug)
-      {
-        debugPrint("NeopixelsClass: Reset x position to %d", textScrollPosition);
-      }
-    }
-    catch (...)
+    // First message or display cleared, start at the right edge (a centred
+    // text is placed at once)
+    appendSegment(newText, centred);
+    this->textScrollPosition = centred ? 0 : tickerWidth;
+    if (debug)
     {
-      if (debug) debugPrint("NeopixelsClass: Exception while resetting position");
-      this->textScrollPosition = width; // Use the stored width if matrix access fails
+      debugPrint("NeopixelsClass: Reset x position to %d", textScrollPosition);
     }
   }
   
-  // Store this text as the previous text for next time
-  previousText = newText;
-  
+  this->text = newText;
+  this->staticText = centred;
+  this->dwelling = false;
+  this->readyForNextMessage = false;
   this->pass = 0;
   this->textComplete = false;
   
@@ -438,6 +567,157 @@ void NeopixelsClass::sendNextText(const std::string& newText)
 } // sendNextText()
 
 
+// Text that stands still, centred, in the left 'columns' columns (a clock),
+// the scrolling text moves to the columns right of it. The layer keeps its
+// own colour, setColor() does not change it. The text is only rendered again
+// when it changes. "" or 0 columns removes the layer.
+void NeopixelsClass::setStaticText(const std::string& newText, int columns, int r, int g, int b)
+{
+  if (!initialized || matrix == nullptr)
+  {
+    if (debug) debugPrint("NeopixelsClass: setStaticText - not initialized, returning");
+    return;
+  }
+  
+  if (postCommand(RENDER_STATIC, columns, r, g, b, newText.c_str())) return;
+  
+  if (newText.empty()) columns = 0;
+  columns = std::max(0, std::min(columns, (int)matrix->width() - 1));
+  uint8_t color[4];
+  toPixelBytes(r, g, b, color);
+  bool resized = (columns != staticLayer.width);
+  bool newColor = (memcmp(staticLayer.color, color, sizeof(staticLayer.color)) != 0);
+  if (!resized && !newColor && newText == staticLayer.text) return;
+  
+  if (resized || newText != staticLayer.text)
+  {
+    staticLayer.text = newText;
+    renderText(newText, staticLayer.columns);
+    centreColumns(staticLayer.columns, columns);
+  }
+  memcpy(staticLayer.color, color, sizeof(staticLayer.color));
+  staticLayer.drawn[0] = staticLayer.drawn[1] = false;
+  
+  if (resized)
+  {
+    staticLayer.width = columns;
+    updateTickerWindow();
+    if (debug) debugPrint("NeopixelsClass: setStaticText - [%d] static columns, text scrolls in [%d] columns", tickerX, tickerWidth);
+  }
+
+} // setStaticText()
+
+
+// Text drawn over everything from column x on, in its own colour, the layers
+// below show through its unlit pixels. "" removes it.
+void NeopixelsClass::setOverlayText(const std::string& newText, int x, int r, int g, int b)
+{
+  if (!initialized || matrix == nullptr)
+  {
+    if (debug) debugPrint("NeopixelsClass: setOverlayText - not initialized, returning");
+    return;
+  }
+  
+  if (postCommand(RENDER_OVERLAY, x, r, g, b, newText.c_str())) return;
+  
+  x = std::max(0, x);
+  uint8_t color[4];
+  toPixelBytes(r, g, b, color);
+  bool newColor = (memcmp(overlayLayer.color, color, sizeof(overlayLayer.color)) != 0);
+  if (!newColor && x == overlayLayer.x && newText == overlayLayer.text) return;
+  
+  if (newText != overlayLayer.text)
+  {
+    overlayLayer.text = newText;
+    renderText(newText, overlayLayer.columns);
+    overlayLayer.columns.resize(std::max(0, (int)overlayLayer.columns.size() - charSpacing()));
+  }
+  memcpy(overlayLayer.color, color, sizeof(overlayLayer.color));
+  overlayLayer.x     = x;
+  overlayLayer.width = std::max(0, std::min((int)overlayLayer.columns.size(), (int)matrix->width() - x));
+  frameValid = false;   // the old overlay pixels may be anywhere
+
+} // setOverlayText()
+
+
+// Number of ticker rows above each other (1 .. NEO_MAX_ROWS), as many as fit
+// the matrix height with the font. Row 0 is the scrolling text with its
+// layers and effects, the others scroll their own texts (see sendRowText()).
+void NeopixelsClass::setRows(int newRows)
+{
+  if (postCommand(RENDER_ROWS, newRows)) return;
+  
+  wantedRows = std::max(1, std::min(newRows, NEO_MAX_ROWS));
+  if (matrix != nullptr && !pixelMap.empty()) updateTickerWindow();
+  
+  if (debug) debugPrint("NeopixelsClass: setRows - [%d] row(s) wanted, [%d] row(s) of [%d] pixels", wantedRows, tickerRows, tickerHeight);
+
+} // setRows()
+
+
+// Queue a text for ticker row 'row' in its own colour, row 0 is setColor()
+// plus sendNextText(). The text starts at the right edge as soon as the row
+// is free. The colour of the other rows and layers does not change.
+void NeopixelsClass::sendRowText(int row, const std::string& newText, int r, int g, int b)
+{
+  if (row == 0)
+  {
+    setColor(r, g, b);
+    sendNextText(newText);
+    return;
+  }
+  if (!initialized || matrix == nullptr)
+  {
+    if (debug) debugPrint("NeopixelsClass: sendRowText - not initialized, returning");
+    return;
+  }
+  
+  if (postCommand(RENDER_ROW_TEXT, row, r, g, b, newText.c_str())) return;
+  
+  if (row < 0 || row >= tickerRows)
+  {
+    if (debug) debugPrint("NeopixelsClass: sendRowText - no ticker row [%d]", row);
+    return;
+  }
+  TickerRow& tickerRow = rows[row - 1];
+  if (tickerRow.queueCount == NEO_ROW_QUEUE)
+  {
+    if (debug) debugPrint("NeopixelsClass: sendRowText - queue of row [%d] full, text dropped", row);
+    return;
+  }
+  
+  QueuedText& queued = tickerRow.queue[(tickerRow.queueHead + tickerRow.queueCount) % NEO_ROW_QUEUE];
+  queued.text = newText;
+  toPixelBytes(r, g, b, queued.color);
+  tickerRow.queueCount++;
+  
+  if (!tickerRow.scrolling) startRowText(tickerRow);
+
+} // sendRowText()
+
+
+// Speed of ticker row 'row' (0 .. 100 like setScrollSpeed(), row 0 is setScrollSpeed())
+void NeopixelsClass::setRowSpeed(int row, int speed)
+{
+  if (row == 0)
+  {
+    setScrollSpeed(speed);
+    return;
+  }
+  if (postCommand(RENDER_ROW_SPEED, row, speed)) return;
+  
+  if (row < 0 || row >= NEO_MAX_ROWS || speed < 0 || speed > 100)
+  {
+    if (debug) debugPrint("NeopixelsClass: setRowSpeed - invalid row [%d] or speed [%d]", row, speed);
+    return;
+  }
+  rows[row - 1].scrollDelay = scaleValue(speed, 0, 100, 100, 0);
+  
+  if (debug) debugPrint("NeopixelsClass: Row [%d] scroll delay: [%dms]", row, rows[row - 1].scrollDelay);
+
+} // setRowSpeed()
+
+
 // Clear the display (ticker)
 void NeopixelsClass::tickerClear()
 {
@@ -447,20 +727,23 @@ void NeopixelsClass::tickerClear()
     return;
   }
   
+  if (postCommand(RENDER_CLEAR)) return;
+  
   try
   {
-    matrix->fillScreen(0);
-    matrix->show();
+    clearFrame();
     
     // Reset continuous scrolling state
+    stopEffect();
+    clearSegments();
     readyForNextMessage = false;
-    previousText = "";
+    lastUpdateTime = 0;
     textComplete = false;
     
     // Reset position
     try
     {
-      this->textScrollPosition = matrix->width();
+      this->textScrollPosition = tickerWidth;
     }
     catch (...)
     {
@@ -487,7 +770,7 @@ void NeopixelsClass::show()
   
   try
   {
-    matrix->show();
+    sendFrontBuffer();
   }
   catch (...)
   {
@@ -509,16 +792,19 @@ bool NeopixelsClass::animateNeopixels(bool triggerCallback)
     if (debug) debugPrint("NeopixelsClass::animateNeopixels - matrix is null, returning");
     return true;
   }
+  
+  if (effect != PA_NO_EFFECT) return animateEffect(triggerCallback);
  
   textComplete = false;
 
-  // Calculate the text width in pixels
-  int textWidth = text.length() * pixelPerChar;
+  // Segments that have scrolled off are released, the width of the rest is known
+  releaseScrolledSegments();
+  int textWidth = ringWidth;
   
   // Calculate the stopping position:
   // We want to stop when the last character is at the right edge of the display
   // This means the position should be: matrixWidth - textWidth
-  int matrixWidth = matrix->width();
+  int matrixWidth = tickerWidth;
   int stopPosition = matrixWidth - textWidth;
   
   // If the text is shorter than the display width, don't scroll past the left edge
@@ -529,15 +815,38 @@ bool NeopixelsClass::animateNeopixels(bool triggerCallback)
   
   try
   {
-    // Clear the display before drawing new content
-    matrix->fillScreen(0);
+    // Catch up when this frame is late, but never past the end of the text
+    if (skipColumns > 0)
+    {
+      textScrollPosition = std::max(textScrollPosition - skipColumns, stopPosition);
+      skipColumns = 0;
+    }
     
-    // Set the cursor position and print the text
-    matrix->setCursor(textScrollPosition, 0);
-    matrix->print(text.c_str());
+    // A centred text stands still at the end of the ring, then it leaves
+    // with an exit effect or the next text pushes it out
+    if (staticText && textScrollPosition <= stopPosition)
+    {
+      textScrollPosition = stopPosition;
+      showPosition(textScrollPosition);
+      
+      if (!dwelling)
+      {
+        dwelling = true;
+        dwellStart = millis();
+      }
+      if (millis() - dwellStart < staticDwellMs) return false;
+      
+      if (debug) debugPrint("NeopixelsClass::animateNeopixels Static text shown for [%u]ms", staticDwellMs);
+      staticText = false;
+      dwelling = false;
+      lastStopPosition = stopPosition;
+      if (startEffect()) return false;
+      
+      return finishText(triggerCallback);
+    }
     
-    // Update the display
-    matrix->show();
+    // Each frame just copies the visible part of the rendered text
+    showPosition(textScrollPosition);
     
     // Move the text position for the next frame
     textScrollPosition--;
@@ -545,13 +854,8 @@ bool NeopixelsClass::animateNeopixels(bool triggerCallback)
     // Check if we've reached the stopping position
     if (textScrollPosition <= stopPosition)
     {
-      if (debug) debugPrint("NeopixelsClass::animateNeopixels Reached end of text");
-      
-      // Text has completed its animation
-      textComplete = true;
-      
-      // Set the flag to indicate we're ready for the next message
-      readyForNextMessage = true;
+      if (debug) debugPrint("NeopixelsClass::animateNeopixels Reached end of text (late frames[%u], dropped frames[%u])"
+                                                                , lateFrames, droppedFrames);
       
       // Store the last stop position
       lastStopPosition = stopPosition;
@@ -559,17 +863,13 @@ bool NeopixelsClass::animateNeopixels(bool triggerCallback)
       // DO NOT reset position for next text
       // textScrollPosition = matrix->width(); 
       
-      if (debug) debugPrint("NeopixelsClass::animateNeopixels complete, triggering callback");
-      else Serial.println("NeopixelsClass::animateNeopixels complete, triggering callback");
+      // A centred text is shown at stopPosition next time and stands still
+      if (staticText) return false;
       
-      // Only call the callback if triggerCallback is true
-      if (textComplete && onFinished && triggerCallback)
-      {
-        if (debug) debugPrint("NeopixelsClass::animateNeopixels Triggering callback with text: [%s]", text.c_str());
-        onFinished(text);
-      }
+      // With an exit effect the text is finished after its last frame
+      if (startEffect()) return false;
       
-      return true;
+      return finishText(triggerCallback);
     }
     
     // Yield to prevent watchdog timer issues
@@ -586,6 +886,201 @@ bool NeopixelsClass::animateNeopixels(bool triggerCallback)
 } // animateNeopixels()
 
 
+// Build and send the frame for xPosition. A frame with the same pixels as the
+// LEDs show (blank gaps, a text that stands still) is not built or sent.
+void NeopixelsClass::showPosition(int xPosition)
+{
+  if (!dithering && !frameChanged(xPosition))
+  {
+    lastFramePosition = xPosition;   // the front buffer is this frame as well
+    unchangedFrames++;
+    return;
+  }
+  
+  FRAME_STATS_BEGIN(buildStart);
+  buildFrame(xPosition);
+  FRAME_STATS_END(frameStats, FRAME_PHASE_BUILD, buildStart);
+  
+  // Update the display
+  FRAME_STATS_BEGIN(showStart);
+  outputFrame();
+  FRAME_STATS_END(frameStats, FRAME_PHASE_SHOW, showStart);
+
+} // showPosition()
+
+
+// The current text is done: ready for the next one and tell the caller
+bool NeopixelsClass::finishText(bool triggerCallback)
+{
+  // Text has completed its animation
+  textComplete = true;
+  
+  // Set the flag to indicate we're ready for the next message
+  readyForNextMessage = true;
+  
+  if (debug) debugPrint("NeopixelsClass::animateNeopixels complete, triggering callback");
+  else Serial.println("NeopixelsClass::animateNeopixels complete, triggering callback");
+  
+  // Only call the callback if triggerCallback is true
+  if (textComplete && onFinished && triggerCallback)
+  {
+    if (debug) debugPrint("NeopixelsClass::animateNeopixels Triggering callback with text: [%s]", text.c_str());
+    FRAME_STATS_BEGIN(callbackStart);
+    onFinished(text);
+    FRAME_STATS_END(frameStats, FRAME_PHASE_CALLBACK, callbackStart);
+  }
+  
+  return true;
+
+} // finishText()
+
+
+// Pick the exit effect for the text that just reached its end, like
+// ParolaClass::getRandomEffect(). False when the next text just scrolls in.
+bool NeopixelsClass::startEffect()
+{
+  if (effectList.empty() || frameBuffer[frontBuffer].empty()) return false;
+  
+  uint8_t picked = effectList[random(0, effectList.size())];
+  switch (picked)
+  {
+    case PA_WIPE:
+    case PA_WIPE_CURSOR:
+    case PA_DISSOLVE:
+    case PA_RANDOM:       effectFrames = tickerWidth;
+                          break;
+    case PA_SCROLL_UP:
+    case PA_SCROLL_DOWN:  effectFrames = tickerHeight;
+                          break;
+    case PA_FADE:         effectFrames = 16;
+                          break;
+    default:              return false;   // PA_NO_EFFECT and effects without a NeoPixel version
+  }
+  
+  effect       = picked;
+  effectFrame  = 0;
+  effectSource = frameBuffer[frontBuffer];   // reuses the capacity of the last one
+  
+  // The overlay is drawn over every effect frame, the source gets the text under it
+  int overlayEnd = std::min(overlayLayer.x + overlayLayer.width, tickerX + tickerWidth);
+  for (int x = std::max(overlayLayer.x, tickerX); x < overlayEnd; x++)
+  {
+    const uint8_t* color;
+    uint16_t bits = segmentColumn(x - tickerX - lastFramePosition, color);
+    drawColumn(effectSource.data(), x, bits, color);
+  }
+  
+  if (debug && doDebug) debugPrint("NeopixelsClass: startEffect - effect[%d], [%d] frames", effect, effectFrames);
+  return true;
+
+} // startEffect()
+
+
+void NeopixelsClass::stopEffect()
+{
+  effect     = PA_NO_EFFECT;
+  fadeLevel  = 256;
+  frameValid = false;   // the next frame is drawn completely
+
+} // stopEffect()
+
+
+// One frame of the exit effect per scroll step, after the last one the
+// display is blank and the next text starts at the right edge
+bool NeopixelsClass::animateEffect(bool triggerCallback)
+{
+  skipColumns = 0;   // effects are short, late frames are not caught up
+  effectFrame++;
+  
+  FRAME_STATS_BEGIN(buildStart);
+  buildEffectFrame(effectFrame);
+  FRAME_STATS_END(frameStats, FRAME_PHASE_BUILD, buildStart);
+  
+  FRAME_STATS_BEGIN(showStart);
+  outputFrame();
+  FRAME_STATS_END(frameStats, FRAME_PHASE_SHOW, showStart);
+  
+  if (effectFrame < effectFrames) return false;
+  
+  stopEffect();
+  clearSegments();
+  clearFrame();
+  textScrollPosition = tickerWidth;
+  
+  return finishText(triggerCallback);
+
+} // animateEffect()
+
+
+// Effect frame 'frame' (1 .. effectFrames) from effectSource into the back
+// buffer. Only the scrolling text takes part, the layers are drawn over it
+// again (PA_FADE only dims the ticker window, see applyFadeLut()). Nothing depends on earlier frames, so frames may be skipped.
+void NeopixelsClass::buildEffectFrame(int frame)
+{
+  int w = matrix->width();
+  int h = tickerHeight;
+  int tickerEnd = tickerX + tickerWidth;
+  uint8_t  backIndex = frontBuffer ^ 1;
+  uint8_t* back = frameBuffer[backIndex].data();
+  const uint8_t* source = effectSource.data();
+  
+  memcpy(back, source, effectSource.size());
+  invalidateRows(backIndex);
+  switch (effect)
+  {
+    case PA_WIPE:
+    case PA_WIPE_CURSOR:
+    {
+      // Columns left of 'edge' are off, the cursor is a lit column at the edge
+      int edge = tickerX + frame * tickerWidth / effectFrames;
+      for (int x = tickerX; x < edge; x++) drawColumn(back, x, 0, pixelBytes);
+      if (effect == PA_WIPE_CURSOR && edge < tickerEnd) drawColumn(back, edge, 0xFFFF, pixelBytes);
+      break;
+    }
+    case PA_DISSOLVE:
+    case PA_RANDOM:
+    {
+      // The first part of dissolveOrder is off
+      size_t off = (size_t)frame * dissolveOrder.size() / effectFrames;
+      for (size_t i = 0; i < off; i++) memset(back + dissolveOrder[i] * bytesPerPixel, 0, bytesPerPixel);
+      break;
+    }
+    case PA_SCROLL_UP:
+    case PA_SCROLL_DOWN:
+    {
+      int shift = (effect == PA_SCROLL_UP) ? frame : -frame;
+      for (int y = 0; y < h; y++)
+      {
+        int from = y + shift;
+        for (int x = tickerX; x < tickerEnd; x++)
+        {
+          uint8_t* pixel = back + pixelMap[y * w + x] * bytesPerPixel;
+          if (from >= 0 && from < h) memcpy(pixel, source + pixelMap[from * w + x] * bytesPerPixel, bytesPerPixel);
+          else                       memset(pixel, 0, bytesPerPixel);
+        }
+      }
+      break;
+    }
+    case PA_FADE:
+    {
+      // The frame stays, the text goes out through fadeLut: levelLut scaled
+      // down like the brightness. levelLut is in light, so the light goes
+      // down linearly.
+      fadeLevel = (uint32_t)(effectFrames - frame) * 256 / effectFrames;
+      break;
+    }
+  }
+  // The source may have an older static text, the layers are drawn again
+  if (staticLayer.width > 0) drawStaticLayer(backIndex);
+  drawOverlay(backIndex);
+  drawRows(backIndex);
+  
+  // Effects change pixels anywhere, the levels are counted again
+  measureFrame(backIndex);
+
+} // buildEffectFrame()
+
+
 // Block until the entire text is displayed
 // Block until the entire text is displayed
 void NeopixelsClass::animateBlocking(const String &text)
@@ -600,22 +1095,31 @@ void NeopixelsClass::animateBlocking(const String &text)
     return;
   }
   
+  // The render task owns the display, the text just goes in the queue
+  if (renderTaskHandle != nullptr)
+  {
+    sendNextText(text.c_str());
+    return;
+  }
+  
   if (debug) debugPrint("NeopixelsClass: Starting animationBlocking for text: %s", text.c_str());
   else    Serial.printf("NeopixelsClass[S]: Starting animationBlocking for text: %s\n", text.c_str()); 
   
   // Clear the display first
-  matrix->fillScreen(0);
-  matrix->show();
+  clearFrame();
   
   // Set the text directly (no concatenation)
   this->text = text.c_str();
+  stopEffect();
+  clearSegments();
+  appendSegment(this->text);
   
   // Always start from the right edge for new text
-  int matrixWidth = matrix->width();
+  int matrixWidth = tickerWidth;
   int textPosition = matrixWidth;
   
-  // Calculate the width of the text in pixels
-  int textWidth = this->text.length() * pixelPerChar;
+  // The width of the text in pixels is known from rendering it
+  int textWidth = ringWidth;
   
   // Calculate the stopping position:
   // We want to stop when the last character is at the right edge of the display
@@ -646,15 +1150,11 @@ void NeopixelsClass::animateBlocking(const String &text)
   int animationStep = 0;
   while (textPosition > stopPosition && animationStep < 1000)
   {
-    // Clear the display and set the cursor position
-    matrix->fillScreen(0);
-    matrix->setCursor(textPosition, 0);
-    
-    // Print the text
-    matrix->print(this->text.c_str());
+    // Copy the visible part of the pre-rendered text
+    buildFrame(textPosition);
     
     // Update the display
-    matrix->show();
+    outputFrame();
     
     // Move the text position for the next frame
     textPosition--;
@@ -674,20 +1174,27 @@ void NeopixelsClass::animateBlocking(const String &text)
   // Store the last stop position
   lastStopPosition = stopPosition;
   
-  // Store this text as the previous text for next time
-  previousText = text.c_str();
-  
   if (debug) debugPrint("NeopixelsClass: animationBlocking complete");
   else   Serial.println("NeopixelsClass[S]: animationBlocking complete");
 
 } // animateBlocking()
 
 
+// Exit effects to pick from, the same textEffect_t list ParolaClass takes.
+// PA_NO_EFFECT (and effects without a NeoPixel version) keep the continuous
+// scroll, the next text comes in right behind the last one.
 void NeopixelsClass::setRandomEffects(const std::vector<uint8_t> &effects)
 {
-  // This can be a no-op or log that it was called
-  if (debug) debugPrint("NeopixelsClass: setRandomEffects called (no effect)");
-}
+  if (effects.empty())
+  {
+    if (debug) debugPrint("NeopixelsClass: setRandomEffects - Warning: Empty effects list");
+    return;
+  }
+  
+  effectList = effects;
+  if (debug) debugPrint("NeopixelsClass: setRandomEffects - Set [%d] effects", effectList.size());
+
+} // setRandomEffects()
 
 void NeopixelsClass::setCallback(std::function<void(const std::string&)> callback)
 {
@@ -716,69 +1223,1458 @@ void NeopixelsClass::loop()
     return;
   }
   
-  unsigned long currentTime = millis();
-  
-  // Only update the animation if enough time has passed
-  if (currentTime - lastUpdateTime >= scrollDelay)
+  // The render task animates, here only the callback is run (it may use LittleFS and the network)
+  if (renderTaskHandle != nullptr)
   {
-    try
+    std::string finished;
+    if (takeFinished(finishedText, finishedPending, finished))
     {
-      animateNeopixels();
-      lastUpdateTime = currentTime;
+      if (onFinished)
+      {
+        FRAME_STATS_BEGIN(callbackStart);
+        onFinished(finished);
+        FRAME_STATS_END(frameStats, FRAME_PHASE_CALLBACK, callbackStart);
+      }
     }
-    catch (...)
+    for (int r = 1; r < NEO_MAX_ROWS; r++)
     {
-      if (debug) debugPrint("NeopixelsClass: Exception in loop");
+      TickerRow& row = rows[r - 1];
+      if (!takeFinished(row.finishedText, row.finishedPending, finished)) continue;
+      if (onRowFinished) onRowFinished(r, finished);
     }
+    return;
+  }
+  
+  stepRows(true);
+  
+  // The text has been shown, the frame stays until the next text (a layer
+  // or ticker row that changed is drawn in it)
+  if (readyForNextMessage)
+  {
+    lastUpdateTime = 0;
+    if (layersChanged()) showPosition(lastFramePosition);
+    return;
   }
+  
+  stepScrollClock(true);
+  showRows();
+
 } // loop()
 
 
-// Helper function to trim text and recalculate scrolling variables
-void NeopixelsClass::trimTextAndRecalculate()
+void NeopixelsClass::stepScrollClock(bool triggerCallback)
 {
-  if (this->text.length() > 256)
+  // The scroll position follows the time: one pixel every scrollStepUs().
+  // When the caller was held up, the frames in between are skipped, not queued.
+  unsigned long currentTime = micros();
+  if (lastUpdateTime == 0)
   {
-    if (debug)
-    {
-      debugPrint("NeopixelsClass: Text length (%d) exceeds 1024 chars, trimming to 100", this->text.length());
-    }
-    
-    // Keep the last 100 characters (most recent content)
-    std::string oldText = this->text;
-    this->text = this->text.substr(this->text.length() - 100);
-    
-    // Calculate how much text was removed
-    int removedLength = oldText.length() - this->text.length();
-    int removedPixels = removedLength * pixelPerChar;
+    lastUpdateTime = currentTime;
+    scrollRemainderUs = 0;
+  }
+  scrollRemainderUs += currentTime - lastUpdateTime;
+  lastUpdateTime = currentTime;
+  
+  uint32_t stepUs = scrollStepUs();
+  if (scrollRemainderUs < stepUs)
+  {
+    if (subPixelScroll) showSubPixel(scrollRemainderUs, stepUs);
+    return;
+  }
+  
+  uint32_t steps = scrollRemainderUs / stepUs;
+  scrollRemainderUs -= steps * stepUs;   // keep the sub-pixel part
+  if (steps > 1)
+  {
+    lateFrames++;
+    droppedFrames += steps - 1;
+    // A stall of more than a screen width would skip text nobody has seen
+    skipColumns = std::min((int)steps - 1, tickerWidth);
+  }
+  
+  subPixelPhase = 0;
+  try
+  {
+    animateNeopixels(triggerCallback);
+  }
+  catch (...)
+  {
+    if (debug) debugPrint("NeopixelsClass: Exception in loop");
+  }
+
+} // stepScrollClock()
+
+
+// Number of sub-pixel frames per pixel step: as many as the LEDs can be
+// written in stepUs, at most NEO_SUBPIXEL_STEPS (below 2: no sub-pixel frames)
+uint8_t NeopixelsClass::subPixelSteps(uint32_t stepUs)
+{
+  return std::min(stepUs / frameUs(), (uint32_t)NEO_SUBPIXEL_STEPS);
+
+} // subPixelSteps()
+
+
+// Between two pixel steps of a scrolling text: show the text remainderUs
+// into the step, in steps of 1/subPixelSteps() column
+void NeopixelsClass::showSubPixel(uint32_t remainderUs, uint32_t stepUs)
+{
+  if (effect != PA_NO_EFFECT || readyForNextMessage || dwelling || pixelMap.empty()) return;
+  // Only from the pixel step the LEDs show
+  if (lastFramePosition != textScrollPosition + 1) return;
+  // A centred text that stops does not move any more
+  if (staticText && textScrollPosition <= std::min(0, tickerWidth - ringWidth)) return;
+  
+  uint8_t steps = subPixelSteps(stepUs);
+  if (steps < 2) return;
+  
+  uint8_t phase = (remainderUs * steps / stepUs) * NEO_SUBPIXEL_STEPS / steps;
+  if (phase == subPixelPhase) return;
+  subPixelPhase = phase;
+  
+  // Nothing moves when the next pixel step looks the same (a blank gap)
+  if (!dithering && !frameChanged(textScrollPosition)) return;
+  
+  FRAME_STATS_BEGIN(buildStart);
+  buildBlendedFrame(textScrollPosition + 1, phase);
+  FRAME_STATS_END(frameStats, FRAME_PHASE_BUILD, buildStart);
+  
+  FRAME_STATS_BEGIN(showStart);
+  outputFrame();
+  FRAME_STATS_END(frameStats, FRAME_PHASE_SHOW, showStart);
+
+} // showSubPixel()
+
+
+// Move the extra ticker rows, every row on its own clock like
+// stepScrollClock(). A row whose text has scrolled off starts its next queued
+// text, with an empty queue the caller is asked for one (onRowFinished()).
+void NeopixelsClass::stepRows(bool triggerCallback)
+{
+  unsigned long currentTime = micros();
+  for (int r = 1; r < tickerRows; r++)
+  {
+    TickerRow& row = rows[r - 1];
+    if (!row.scrolling) continue;
+    
+    if (row.lastUpdateTime == 0)
+    {
+      row.lastUpdateTime = currentTime;
+      row.remainderUs = 0;
+    }
+    row.remainderUs += currentTime - row.lastUpdateTime;
+    row.lastUpdateTime = currentTime;
+    
+    uint32_t stepUs = std::max((uint32_t)row.scrollDelay * 1000, frameUs());
+    if (row.remainderUs < stepUs) continue;
+    
+    // Late passes skip columns, but never more than a screen width
+    uint32_t steps = row.remainderUs / stepUs;
+    row.remainderUs -= steps * stepUs;
+    row.position -= std::min((int)steps, (int)matrix->width());
+    row.version++;
+    if (row.position > -(int)row.columns.size()) continue;
+    
+    startRowText(row);
+    if (row.scrolling) continue;
+    
+    if (triggerCallback)
+    {
+      if (onRowFinished) onRowFinished(r, row.text);
+    }
+    else
+    {
+      postFinished(row.finishedText, row.finishedPending, row.text);
+    }
+  }
+
+} // stepRows()
+
+
+// The next queued text of a ticker row at the right edge, or an empty row
+void NeopixelsClass::startRowText(TickerRow& row)
+{
+  row.version++;
+  if (row.queueCount == 0)
+  {
+    row.scrolling = false;
+    row.columns.clear();   // row.text stays for onRowFinished()
+    return;
+  }
+  
+  // Swapped, so the strings take turns with their capacity
+  QueuedText& next = row.queue[row.queueHead];
+  std::swap(row.text, next.text);
+  memcpy(row.color, next.color, sizeof(row.color));
+  row.queueHead = (row.queueHead + 1) % NEO_ROW_QUEUE;
+  row.queueCount--;
+  
+  renderText(row.text, row.columns);
+  row.position       = matrix->width();
+  row.scrolling      = true;
+  row.lastUpdateTime = 0;
+
+} // startRowText()
+
+
+// Time until the next step of a ticker row
+uint32_t NeopixelsClass::rowWaitUs()
+{
+  uint32_t waitUs = UINT32_MAX;
+  for (int r = 1; r < tickerRows; r++)
+  {
+    const TickerRow& row = rows[r - 1];
+    if (!row.scrolling) continue;
+    uint32_t stepUs = std::max((uint32_t)row.scrollDelay * 1000, frameUs());
+    waitUs = std::min(waitUs, (row.remainderUs < stepUs) ? stepUs - row.remainderUs : 0);
+  }
+  return waitUs;
+
+} // rowWaitUs()
+
+
+// A ticker row moved while the scrolling text did not: the frame the LEDs
+// show is built again, with the new rows in it
+void NeopixelsClass::showRows()
+{
+  if (pixelMap.empty() || !rowsChanged()) return;
+  
+  FRAME_STATS_BEGIN(buildStart);
+  if (effect != PA_NO_EFFECT && effectFrame > 0)  buildEffectFrame(effectFrame);
+  else if (subPixelPhase > 0)                     buildBlendedFrame(lastFramePosition, subPixelPhase);
+  else                                            buildFrame(lastFramePosition);
+  FRAME_STATS_END(frameStats, FRAME_PHASE_BUILD, buildStart);
+  
+  FRAME_STATS_BEGIN(showStart);
+  outputFrame();
+  FRAME_STATS_END(frameStats, FRAME_PHASE_SHOW, showStart);
+
+} // showRows()
+
+
+// Start the task that does all display work from now on, pinned to the core
+// that does not run WiFi. The other tasks only post commands to its queue.
+bool NeopixelsClass::startRenderTask(uint8_t core)
+{
+  if (renderTaskHandle != nullptr) return true;
+  
+  if (!initialized || matrix == nullptr)
+  {
+    if (debug) debugPrint("NeopixelsClass: startRenderTask - not initialized, returning");
+    return false;
+  }
+  
+  if (renderQueue == nullptr)
+  {
+    renderQueue = xQueueCreate(RENDER_QUEUE_LENGTH, sizeof(RenderCommand));
+    if (renderQueue == nullptr)
+    {
+      if (debug) debugPrint("NeopixelsClass: startRenderTask - could not create queue");
+      return false;
+    }
+  }
+  
+  lastUpdateTime    = 0;
+  finishedPending   = false;
+  renderTaskRunning = true;
+  if (xTaskCreatePinnedToCore(renderTask, "neoRender", RENDER_TASK_STACK, this
+                                        , RENDER_TASK_PRIORITY, &renderTaskHandle, core) != pdPASS)
+  {
+    renderTaskHandle  = nullptr;
+    renderTaskRunning = false;
+    if (debug) debugPrint("NeopixelsClass: startRenderTask - could not create task");
+    return false;
+  }
+  
+  if (debug) debugPrint("NeopixelsClass: Render task started on core %d", core);
+  return true;
+
+} // startRenderTask()
+
+
+void NeopixelsClass::stopRenderTask()
+{
+  if (renderTaskHandle == nullptr || inRenderTask()) return;
+  
+  // Let the task finish its frame and end itself
+  RenderCommand command = {RENDER_STOP, {0, 0, 0, 0}, nullptr};
+  xQueueSend(renderQueue, &command, portMAX_DELAY);
+  while (renderTaskRunning)
+  {
+    vTaskDelay(1);
+  }
+  renderTaskHandle = nullptr;
+  
+  // Drop what was still queued
+  while (xQueueReceive(renderQueue, &command, 0) == pdTRUE)
+  {
+    free(command.text);
+  }
+  finishedPending = false;
+
+} // stopRenderTask()
+
+
+bool NeopixelsClass::inRenderTask() const
+{
+  return renderTaskHandle != nullptr && xTaskGetCurrentTaskHandle() == renderTaskHandle;
+
+} // inRenderTask()
+
+
+// Hand a command to the render task, false if the caller has to do it itself
+// (no render task or already in the render task)
+bool NeopixelsClass::postCommand(uint8_t type, int v0, int v1, int v2, int v3, const char* text)
+{
+  if (renderTaskHandle == nullptr || inRenderTask()) return false;
+  
+  RenderCommand command = {type, {v0, v1, v2, v3}, (text != nullptr) ? strdup(text) : nullptr};
+  if (xQueueSend(renderQueue, &command, pdMS_TO_TICKS(100)) != pdTRUE)
+  {
+    if (debug) debugPrint("NeopixelsClass: Render queue full, command [%d] dropped", type);
+    free(command.text);
+  }
+  return true;
+
+} // postCommand()
+
+
+void NeopixelsClass::handleCommand(RenderCommand& command)
+{
+  switch (command.type)
+  {
+    case RENDER_TEXT:       sendNextText((command.text != nullptr) ? command.text : "");
+                            break;
+    case RENDER_COLOR:      setColor(command.value[0], command.value[1], command.value[2]);
+                            break;
+    case RENDER_INTENSITY:  setIntensity(command.value[0]);
+                            break;
+    case RENDER_SPEED:      setScrollSpeed(command.value[0]);
+                            break;
+    case RENDER_CLEAR:      tickerClear();
+                            break;
+    case RENDER_STATIC:     setStaticText((command.text != nullptr) ? command.text : "", command.value[0]
+                                        , command.value[1], command.value[2], command.value[3]);
+                            break;
+    case RENDER_OVERLAY:    setOverlayText((command.text != nullptr) ? command.text : "", command.value[0]
+                                         , command.value[1], command.value[2], command.value[3]);
+                            break;
+    case RENDER_ROWS:       setRows(command.value[0]);
+                            break;
+    case RENDER_ROW_TEXT:   sendRowText(command.value[0], (command.text != nullptr) ? command.text : ""
+                                      , command.value[1], command.value[2], command.value[3]);
+                            break;
+    case RENDER_ROW_SPEED:  setRowSpeed(command.value[0], command.value[1]);
+                            break;
+  }
+  free(command.text);
+
+} // handleCommand()
+
+
+void NeopixelsClass::renderLoop()
+{
+  RenderCommand command;
+  
+  while (true)
+  {
+    // Sleep until a command arrives or the next pixel step is due
+    uint32_t stepUs = scrollStepUs();
+    uint32_t waitUs = (scrollRemainderUs < stepUs) ? stepUs - scrollRemainderUs : 0;
+    uint8_t  subSteps = subPixelScroll ? subPixelSteps(stepUs) : 1;
+    if (subSteps > 1 && !readyForNextMessage)
+    {
+      // or the next sub-pixel frame
+      uint32_t subStepUs = stepUs / subSteps;
+      waitUs = std::min(waitUs, subStepUs - scrollRemainderUs % subStepUs);
+    }
+    waitUs = std::min(waitUs, rowWaitUs());   // or the next step of a ticker row
+    TickType_t waitTicks = std::max((TickType_t)1, (TickType_t)pdMS_TO_TICKS(waitUs / 1000));
     
-    // Adjust the x position to maintain visual continuity
-    // Since we removed text from the beginning, we need to move x to the right
-    this->textScrollPosition += removedPixels;
+    while (xQueueReceive(renderQueue, &command, waitTicks) == pdTRUE)
+    {
+      if (command.type == RENDER_STOP) return;
+      handleCommand(command);
+      waitTicks = 0;
+    }
     
-    // Recalculate text width and stop position
-    int textWidth = this->text.length() * pixelPerChar;
-    int matrixWidth = matrix->width();
-    int newStopPosition = matrixWidth - textWidth;
+    stepRows(false);
     
-    // If the text is shorter than the display width, don't scroll past the left edge
-    if (newStopPosition > 0)
+    // Hold the last frame until loop() has handed over the next text
+    if (readyForNextMessage)
     {
-      newStopPosition = 0;
+      lastUpdateTime = 0;
+      if (layersChanged())  showPosition(lastFramePosition);   // e.g. the clock changed
+      else if (dithering)   sendFrontBuffer();   // keep the dither running on a still frame
+      continue;
     }
     
-    // Update the last stop position
-    lastStopPosition = newStopPosition;
+    stepScrollClock(false);
+    showRows();
     
-    if (debug)
+    if (readyForNextMessage) postFinished(finishedText, finishedPending, text);
+  }
+
+} // renderLoop()
+
+
+// Hand a finished text from the render task to loop() (see takeFinished()).
+// The cores meet under frameMux; the text is copied before and only swapped
+// in with it held, nothing is allocated in the critical section.
+void NeopixelsClass::postFinished(std::string& slot, bool& pending, const std::string& text)
+{
+  std::string copy = text;
+  portENTER_CRITICAL(&frameMux);
+  if (!pending)
+  {
+    slot.swap(copy);
+    pending = true;
+  }
+  portEXIT_CRITICAL(&frameMux);
+
+} // postFinished()
+
+
+// True when the render task posted a finished text, it is moved into 'text'
+bool NeopixelsClass::takeFinished(std::string& slot, bool& pending, std::string& text)
+{
+  text.clear();   // the slot gets this buffer back, empty
+  portENTER_CRITICAL(&frameMux);
+  bool taken = pending;
+  if (taken)
+  {
+    text.swap(slot);
+    pending = false;
+  }
+  portEXIT_CRITICAL(&frameMux);
+  return taken;
+
+} // takeFinished()
+
+
+void NeopixelsClass::renderTask(void* parameter)
+{
+  NeopixelsClass* self = static_cast<NeopixelsClass*>(parameter);
+  
+  self->renderLoop();
+  
+  self->renderTaskRunning = false;
+  vTaskDelete(nullptr);
+
+} // renderTask()
+
+
+// Rasterize a text (segment or layer) once, so a frame only has to copy the
+// visible columns, whatever the length of the text.
+void NeopixelsClass::renderText(const std::string& text, std::vector<uint16_t>& columns)
+{
+  int spacing = charSpacing();
+  
+  columns.clear();   // keeps the capacity of an earlier message
+  columns.reserve(measureText(text));
+  
+  size_t iconLength;
+  const char* p = text.c_str();
+  while (*p)
+  {
+    int8_t icon = weatherIconAt(p, iconLength);
+    if (icon >= 0)
+    {
+      const WeatherSprite& sprite = weatherSprites()[icon];
+      columns.insert(columns.end(), sprite.columns, sprite.columns + sprite.width);
+      columns.insert(columns.end(), spacing, 0);
+      p += iconLength;
+      continue;
+    }
+    const uint8_t* glyphColumns;
+    uint8_t width = nextGlyph(p, glyphColumns);
+    columns.insert(columns.end(), glyphColumns, glyphColumns + width);
+    columns.insert(columns.end(), spacing, 0);
+  }
+  
+  if (debug && doDebug) debugPrint("NeopixelsClass: renderText - [%d] columns", columns.size());
+
+} // renderText()
+
+
+// Drop the spacing after the last glyph and centre the columns in columnsWide
+// columns, of a text that is too wide the left part is kept
+void NeopixelsClass::centreColumns(std::vector<uint16_t>& columns, int columnsWide)
+{
+  int textWidth = std::max(0, (int)columns.size() - charSpacing());
+  columns.resize(std::min(textWidth, columnsWide));
+  columns.insert(columns.begin(), (columnsWide - (int)columns.size()) / 2, 0);
+  columns.resize(columnsWide, 0);
+
+} // centreColumns()
+
+
+// Add a rendered segment at the end of the ring. A full ring first drops its
+// oldest segment, which normally has long scrolled off. A centred segment is
+// padded to the display width, without the spacing after its last glyph.
+void NeopixelsClass::appendSegment(const std::string& segmentText, bool centred)
+{
+  if (segmentCount == NEO_MAX_SEGMENTS) releaseHeadSegment();
+  
+  TextSegment& segment = segments[(segmentHead + segmentCount) % NEO_MAX_SEGMENTS];
+  segment.text = segmentText;
+  memcpy(segment.color, pixelBytes, sizeof(segment.color));   // keeps this colour while it scrolls
+  renderText(segment.text, segment.columns);
+  if (centred) centreColumns(segment.columns, tickerWidth);
+  ringWidth += segment.columns.size();
+  segmentCount++;
+  frameValid = false;   // the new columns may already be on screen
+
+} // appendSegment()
+
+
+// Drop the oldest segment, textScrollPosition moves to the start of the next one
+void NeopixelsClass::releaseHeadSegment()
+{
+  if (segmentCount == 0) return;
+  
+  TextSegment& segment = segments[segmentHead];
+  int segmentWidth = segment.columns.size();
+  
+  textScrollPosition += segmentWidth;
+  lastFramePosition  += segmentWidth;   // same frame, so shifting stays valid
+  ringWidth          -= segmentWidth;
+  segment.columns.clear();
+  segment.text.clear();
+  segmentHead = (segmentHead + 1) % NEO_MAX_SEGMENTS;
+  segmentCount--;
+
+} // releaseHeadSegment()
+
+
+// Release the segments that are completely left of the display
+void NeopixelsClass::releaseScrolledSegments()
+{
+  while (segmentCount > 1 && textScrollPosition + (int)segments[segmentHead].columns.size() <= 0)
+  {
+    if (debug && doDebug) debugPrint("NeopixelsClass: Releasing segment [%s]", segments[segmentHead].text.c_str());
+    releaseHeadSegment();
+  }
+
+} // releaseScrolledSegments()
+
+
+void NeopixelsClass::clearSegments()
+{
+  while (segmentCount > 0)
+  {
+    releaseHeadSegment();
+  }
+  segmentHead = 0;
+  ringWidth   = 0;
+  staticText  = false;
+  dwelling    = false;
+
+} // clearSegments()
+
+
+// Column 'column' of all segments together, counted from the head segment,
+// color is set to the colour of the segment it is in
+uint16_t NeopixelsClass::segmentColumn(int column, const uint8_t*& color)
+{
+  color = pixelBytes;
+  if (column < 0) return 0;
+  
+  for (uint8_t i = 0; i < segmentCount; i++)
+  {
+    const TextSegment& segment = segments[(segmentHead + i) % NEO_MAX_SEGMENTS];
+    if (column < (int)segment.columns.size())
+    {
+      color = segment.color;
+      return segment.columns[column];
+    }
+    column -= segment.columns.size();
+  }
+  return 0;
+
+} // segmentColumn()
+
+
+// False when the frame for xPosition has the same pixels as the front buffer
+// (built for lastFramePosition). Compares the visible text columns, so it
+// costs a fraction of building the frame.
+bool NeopixelsClass::frameChanged(int xPosition)
+{
+  if (layersChanged()) return true;
+  if (xPosition == lastFramePosition) return false;
+  
+  uint16_t rowMask = (1UL << tickerHeight) - 1;
+  for (int x = 0; x < tickerWidth; x++)
+  {
+    const uint8_t* newColor;
+    const uint8_t* oldColor;
+    uint16_t newBits = segmentColumn(x - xPosition, newColor) & rowMask;
+    uint16_t oldBits = segmentColumn(x - lastFramePosition, oldColor) & rowMask;
+    if (newBits != oldBits) return true;
+    if (newBits != 0 && memcmp(newColor, oldColor, bytesPerPixel) != 0) return true;
+  }
+  return false;
+
+} // frameChanged()
+
+
+// Precompute the XY -> pixel index mapping (same as Adafruit_NeoMatrix::XY()
+// for one row of tiles, left to right) and find out how the buffer can be
+// shifted one column.
+void NeopixelsClass::buildPixelMap()
+{
+  int w = matrix->width();
+  int h = matrix->height();
+  int panelWidth = w / panels;
+  uint8_t config = matrixType + matrixDirection + matrixLayout + matrixSequence;
+  
+  pixelMap.assign(w * h, 0);
+  for (int y = 0; y < h; y++)
+  {
+    for (int x = 0; x < w; x++)
+    {
+      int panel = x / panelWidth;
+      uint16_t minor = x - panel * panelWidth;
+      uint16_t major = y;
+      uint16_t majorScale;
+      uint16_t panelStart = panel * panelWidth * h;
+      
+      if (config & NEO_MATRIX_RIGHT)  minor = panelWidth - 1 - minor;
+      if (config & NEO_MATRIX_BOTTOM) major = h - 1 - major;
+      
+      if ((config & NEO_MATRIX_AXIS) == NEO_MATRIX_ROWS)
+      {
+        majorScale = panelWidth;
+      }
+      else
+      {
+        std::swap(major, minor);
+        majorScale = h;
+      }
+      
+      if (((config & NEO_MATRIX_SEQUENCE) == NEO_MATRIX_ZIGZAG) && (major & 1))
+            pixelMap[y * w + x] = panelStart + (major + 1) * majorScale - 1 - minor;
+      else  pixelMap[y * w + x] = panelStart + major * majorScale + minor;
+    }
+  }
+  
+  // RGBW types have a separate white offset
+  bytesPerPixel = (((pixelType >> 6) & 3) == ((pixelType >> 4) & 3)) ? 3 : 4;
+  frameBuffer[0].assign(w * h * bytesPerPixel, 0);
+  frameBuffer[1].assign(w * h * bytesPerPixel, 0);
+  columnLevel[0].assign(w, 0);
+  columnLevel[1].assign(w, 0);
+  frameLevel[0] = frameLevel[1] = 0;
+  frontBuffer = 0;
+  updatePixelBytes();
+  
+  // A row that is one contiguous run can be shifted with one memmove(), if all
+  // rows have the same (column) stride the whole frame is one memmove()
+  shiftMode  = SHIFT_PIXELS;
+  shiftDelta = (w > 1) ? pixelMap[1] - pixelMap[0] : 0;
+  bool contiguous = (w > 1);
+  bool allUnit    = true;
+  bool allSame    = true;
+  for (int y = 0; y < h && contiguous; y++)
+  {
+    const uint16_t* row = &pixelMap[y * w];
+    int d = row[1] - row[0];
+    if (d != 1 && d != -1) allUnit = false;
+    if (d != shiftDelta)   allSame = false;
+    for (int x = 2; x < w; x++)
+    {
+      if (row[x] - row[x - 1] != d) contiguous = false;
+    }
+  }
+  if      (contiguous && allUnit)                                    shiftMode = SHIFT_ROWS;
+  else if (contiguous && allSame && (shiftDelta == h || shiftDelta == -h)) shiftMode = SHIFT_BLOCK;
+  updateTickerWindow();
+  
+  if (debug) debugPrint("NeopixelsClass: buildPixelMap - config 0x%02x, shiftMode %d", config, shiftMode);
+
+} // buildPixelMap()
+
+
+// Order in which PA_DISSOLVE switches the pixels of the scrolling text off. A
+// maximal length Galois LFSR visits every value from 1 to 2^bits - 1 once in a
+// scattered order, values beyond the number of pixels are skipped. No random()
+// per pixel.
+void NeopixelsClass::buildDissolveOrder()
+{
+  static const uint16_t taps[17] = { 0, 0, 0x3, 0x6, 0xC, 0x14, 0x30, 0x60, 0xB8
+                                   , 0x110, 0x240, 0x500, 0xE08, 0x1C80, 0x3802, 0x6000, 0xD008 };
+  int w = matrix->width();
+  size_t pixels = (size_t)tickerWidth * tickerHeight;
+  uint8_t bits = 2;
+  while (bits < 16 && ((1UL << bits) - 1) < pixels) bits++;
+  
+  dissolveOrder.clear();
+  dissolveOrder.reserve(pixels);
+  uint16_t lfsr = 1;
+  do
+  {
+    if (lfsr <= pixels)
     {
-      debugPrint("NeopixelsClass: Text trimmed from %d to %d chars", oldText.length(), this->text.length());
-      debugPrint("NeopixelsClass: Adjusted x position by +%d pixels to %d", removedPixels, this->textScrollPosition);
-      debugPrint("NeopixelsClass: New stop position: %d", newStopPosition);
-      debugPrint("NeopixelsClass: Trimmed text: '%s'", this->text.c_str());
+      int y = (lfsr - 1) / tickerWidth;
+      int x = tickerX + (lfsr - 1) % tickerWidth;
+      dissolveOrder.push_back(pixelMap[y * w + x]);
+    }
+    lfsr = (lfsr & 1) ? (lfsr >> 1) ^ taps[bits] : (lfsr >> 1);
+  } while (lfsr != 1);
+
+} // buildDissolveOrder()
+
+
+// textColor as the bytes in the frame buffer, in the order of pixelType. The
+// brightness is applied when the frame is sent (see applyLevelLut()). Only
+// segments added after this use it, text on screen keeps its colour.
+void NeopixelsClass::updatePixelBytes()
+{
+  toPixelBytes(red, green, blue, pixelBytes);
+
+} // updatePixelBytes()
+
+
+// An RGB colour as the bytes in the frame buffer, in the order of pixelType
+void NeopixelsClass::toPixelBytes(int r, int g, int b, uint8_t* bytes)
+{
+  memset(bytes, 0, 4);
+  bytes[(pixelType >> 4) & 3] = std::max(0, std::min(r, 255));
+  bytes[(pixelType >> 2) & 3] = std::max(0, std::min(g, 255));
+  bytes[ pixelType       & 3] = std::max(0, std::min(b, 255));
+
+} // toPixelBytes()
+
+
+// Copy the text columns of the frame in src one column to the left into dst,
+// the right text column of dst is left for drawColumn(). Only the rows of the
+// scrolling text, the extra ticker rows are drawn by drawRows().
+void NeopixelsClass::shiftFrameLeft(const uint8_t* src, uint8_t* dst)
+{
+  int w = matrix->width();
+  int h = matrix->height();
+  int first = tickerX;
+  int last  = tickerX + tickerWidth - 1;
+  
+  if (shiftMode == SHIFT_BLOCK && tickerHeight == h)
+  {
+    // Columns are runs of h pixels, left to right or right to left
+    int dest = ((shiftDelta > 0) ? pixelMap[first] : pixelMap[last - 1]) / h * h;
+    memcpy(dst + dest * bytesPerPixel, src + (dest + shiftDelta) * bytesPerPixel, (last - first) * h * bytesPerPixel);
+  }
+  else if (shiftMode == SHIFT_ROWS)
+  {
+    for (int y = 0; y < tickerHeight; y++)
+    {
+      const uint16_t* row = &pixelMap[y * w];
+      int d    = row[1] - row[0];
+      int dest = (d > 0) ? row[first] : row[last - 1];
+      memcpy(dst + dest * bytesPerPixel, src + (dest + d) * bytesPerPixel, (last - first) * bytesPerPixel);
+    }
+  }
+  else
+  {
+    // Column by column, so COLUMNS layouts walk the buffer (almost) in order
+    for (int x = first; x < last; x++)
+    {
+      const uint16_t* map = &pixelMap[x];
+      for (int y = 0; y < tickerHeight; y++, map += w)
+      {
+        uint8_t*       to   = dst + map[0] * bytesPerPixel;
+        const uint8_t* from = src + map[1] * bytesPerPixel;
+        to[0] = from[0];
+        to[1] = from[1];
+        to[2] = from[2];
+        if (bytesPerPixel == 4) to[3] = from[3];
+      }
     }
   }
-} // trimTextAndRecalculate()
+
+} // shiftFrameLeft()
+
+
+// One column of a ticker row: tickerHeight rows from row 'top'
+void NeopixelsClass::drawColumn(uint8_t* buffer, int x, uint16_t bits, const uint8_t* color, int top)
+{
+  int w = matrix->width();
+  for (int y = top; y < top + tickerHeight; y++, bits >>= 1)
+  {
+    uint8_t* pixel = buffer + pixelMap[y * w + x] * bytesPerPixel;
+    if (bits & 1) memcpy(pixel, color, bytesPerPixel);
+    else          memset(pixel, 0, bytesPerPixel);
+  }
+
+} // drawColumn()
+
+
+// Build the frame for the text starting at xPosition in the back buffer, with
+// the layers. When the front buffer holds the frame one column to the right
+// the text columns are shifted and only the new right column is drawn, at the
+// same position the front buffer is copied, else the visible columns are
+// drawn. The static layer is only drawn in a buffer that does not hold it yet.
+void NeopixelsClass::buildFrame(int xPosition)
+{
+  if (pixelMap.empty()) return;
+  
+  uint16_t rowMask = (1UL << tickerHeight) - 1;
+  uint8_t  backIndex = frontBuffer ^ 1;
+  uint8_t* back = frameBuffer[backIndex].data();
+  std::vector<uint16_t>& levels = columnLevel[backIndex];
+  const std::vector<uint16_t>& frontLevels = columnLevel[frontBuffer];
+  
+  if (incrementalScroll && frameValid && xPosition == lastFramePosition - 1)
+  {
+    shiftFrameLeft(frameBuffer[frontBuffer].data(), back);
+    int right = tickerX + tickerWidth - 1;
+    const uint8_t* color;
+    uint16_t bits = segmentColumn(tickerWidth - 1 - xPosition, color);
+    drawColumn(back, right, bits, color);
+    
+    // The column levels shift along, only the new column is counted
+    memcpy(levels.data() + tickerX, frontLevels.data() + tickerX + 1, (tickerWidth - 1) * sizeof(uint16_t));
+    levels[right] = __builtin_popcount(bits & rowMask) * colorLevel(color);
+  }
+  else if (frameValid && xPosition == lastFramePosition)
+  {
+    // Only a layer changed
+    memcpy(back, frameBuffer[frontBuffer].data(), frameBuffer[0].size());
+    levels = frontLevels;
+    staticLayer.drawn[backIndex] = staticLayer.drawn[frontBuffer];
+    copyRows(frontBuffer, backIndex);
+  }
+  else
+  {
+    memset(back, 0, frameBuffer[0].size());
+    std::fill(levels.begin(), levels.end(), 0);
+    staticLayer.drawn[backIndex] = false;
+    invalidateRows(backIndex);
+    int x = xPosition;
+    for (uint8_t i = 0; i < segmentCount && x < tickerWidth; i++)
+    {
+      const TextSegment& segment = segments[(segmentHead + i) % NEO_MAX_SEGMENTS];
+      uint16_t segmentLevel = colorLevel(segment.color);
+      for (size_t c = 0; c < segment.columns.size() && x < tickerWidth; c++, x++)
+      {
+        if (x < 0) continue;
+        drawColumn(back, tickerX + x, segment.columns[c], segment.color);
+        levels[tickerX + x] = __builtin_popcount(segment.columns[c] & rowMask) * segmentLevel;
+      }
+    }
+  }
+  if (staticLayer.width > 0 && !staticLayer.drawn[backIndex]) drawStaticLayer(backIndex);
+  repairOverlay(backIndex, xPosition);
+  drawRows(backIndex);
+  sumLevels(backIndex);
+  
+  // Valid for the front buffer as soon as outputFrame() has swapped them
+  lastFramePosition = xPosition;
+  frameValid = true;
+
+} // buildFrame()
+
+
+// The frame for the text between xPosition and xPosition - 1 ('phase'
+// sixteenths of the way) in the back buffer. Every LED blends the two text
+// columns that pass it, with blendWeight so the light moves over linearly.
+// Integer math only: per column the three lit combinations (old column,
+// new column, both) are blended once and the LEDs pick theirs by two bits.
+void NeopixelsClass::buildBlendedFrame(int xPosition, uint8_t phase)
+{
+  int w = matrix->width();
+  int h = tickerHeight;
+  uint16_t rowMask = (1UL << h) - 1;
+  uint8_t  backIndex = frontBuffer ^ 1;
+  uint8_t* back = frameBuffer[backIndex].data();
+  std::vector<uint16_t>& levels = columnLevel[backIndex];
+  uint16_t oldWeight = blendWeight[NEO_SUBPIXEL_STEPS - phase];
+  uint16_t newWeight = blendWeight[phase];
+  uint8_t  blend[4][4] = {{0}};   // [new bit << 1 | old bit]
+  
+  for (int x = 0; x < tickerWidth; x++)
+  {
+    const uint8_t* oldColor;
+    const uint8_t* newColor;
+    uint16_t oldBits = segmentColumn(x - xPosition, oldColor) & rowMask;
+    uint16_t newBits = segmentColumn(x - xPosition + 1, newColor) & rowMask;
+    
+    bool sameColor = (memcmp(oldColor, newColor, bytesPerPixel) == 0);
+    for (uint8_t i = 0; i < bytesPerPixel; i++)
+    {
+      uint32_t oldPart = oldColor[i] * oldWeight;
+      uint32_t newPart = newColor[i] * newWeight;
+      blend[1][i] = (oldPart + 128) >> 8;
+      blend[2][i] = (newPart + 128) >> 8;
+      blend[3][i] = sameColor ? oldColor[i] : std::min((oldPart + newPart + 128) >> 8, (uint32_t)255);
+    }
+    
+    const uint16_t* map = &pixelMap[tickerX + x];
+    for (int y = 0; y < h; y++, map += w)
+    {
+      uint8_t lit = ((oldBits >> y) & 1) | (((newBits >> y) & 1) << 1);
+      memcpy(back + map[0] * bytesPerPixel, blend[lit], bytesPerPixel);
+    }
+    levels[tickerX + x] = __builtin_popcount(oldBits & ~newBits) * colorLevel(blend[1])
+                        + __builtin_popcount(newBits & ~oldBits) * colorLevel(blend[2])
+                        + __builtin_popcount(oldBits &  newBits) * colorLevel(blend[3]);
+  }
+  if (staticLayer.width > 0 && !staticLayer.drawn[backIndex]) drawStaticLayer(backIndex);
+  drawOverlay(backIndex);
+  drawRows(backIndex);
+  sumLevels(backIndex);
+  
+  // No whole pixel frame to shift, the next one is drawn completely
+  lastFramePosition = xPosition;
+  frameValid = false;
+
+} // buildBlendedFrame()
+
+
+// Make the back buffer the front buffer and write it to the LEDs
+void NeopixelsClass::outputFrame()
+{
+  portENTER_CRITICAL(&frameMux);
+  frontBuffer ^= 1;
+  portEXIT_CRITICAL(&frameMux);
+  
+  sendFrontBuffer();
+
+} // outputFrame()
+
+
+// Blank the scrolling text (the layers stay), the next frame is drawn completely
+void NeopixelsClass::clearFrame()
+{
+  uint8_t backIndex = frontBuffer ^ 1;
+  std::vector<uint8_t>& back = frameBuffer[backIndex];
+  std::fill(back.begin(), back.end(), 0);
+  std::fill(columnLevel[backIndex].begin(), columnLevel[backIndex].end(), 0);
+  staticLayer.drawn[backIndex] = false;
+  invalidateRows(backIndex);
+  if (staticLayer.width > 0) drawStaticLayer(backIndex);
+  drawOverlay(backIndex);
+  drawRows(backIndex);
+  sumLevels(backIndex);
+  outputFrame();
+  frameValid = false;
+
+} // clearFrame()
+
+
+// Clip rectangle of the scrolling text: the columns right of the static layer,
+// the top ticker row. The text columns move, so the next frame is drawn completely.
+void NeopixelsClass::updateTickerWindow()
+{
+  int w = matrix->width();
+  int h = matrix->height();
+  staticLayer.width  = std::max(0, std::min(staticLayer.width, w - 1));
+  overlayLayer.width = std::max(0, std::min((int)overlayLayer.columns.size(), w - overlayLayer.x));
+  tickerX     = staticLayer.width;
+  tickerWidth = w - tickerX;
+  
+  // Every ticker row needs the height of the font, one row gets all rows
+  tickerRows   = std::max(1, std::min(wantedRows, h / NEO_FONT_HEIGHT));
+  tickerHeight = std::min(h / tickerRows, 16);   // a column is 16 bits
+  staticLayer.drawn[0] = staticLayer.drawn[1] = false;
+  invalidateRows(0);
+  invalidateRows(1);
+  frameValid = false;
+  buildDissolveOrder();
+
+} // updateTickerWindow()
+
+
+void NeopixelsClass::drawStaticLayer(uint8_t buffer)
+{
+  uint8_t* frame = frameBuffer[buffer].data();
+  uint16_t rowMask = (1UL << tickerHeight) - 1;
+  uint16_t level = colorLevel(staticLayer.color);
+  for (int i = 0; i < staticLayer.width; i++)
+  {
+    int x = staticLayer.x + i;
+    drawColumn(frame, x, staticLayer.columns[i], staticLayer.color);
+    columnLevel[buffer][x] = __builtin_popcount(staticLayer.columns[i] & rowMask) * level;
+  }
+  staticLayer.drawn[buffer] = true;
+
+} // drawStaticLayer()
+
+
+// The lit pixels of the overlay over what the buffer holds
+void NeopixelsClass::drawOverlay(uint8_t buffer)
+{
+  int w = matrix->width();
+  uint8_t* frame = frameBuffer[buffer].data();
+  for (int i = 0; i < overlayLayer.width; i++)
+  {
+    int x = overlayLayer.x + i;
+    uint16_t bits = overlayLayer.columns[i];
+    for (int y = 0; bits != 0; y++, bits >>= 1)
+    {
+      if ((bits & 1) && y < tickerHeight) memcpy(frame + pixelMap[y * w + x] * bytesPerPixel, overlayLayer.color, bytesPerPixel);
+    }
+    columnLevel[buffer][x] = measureColumn(buffer, x);
+  }
+
+} // drawOverlay()
+
+
+// Shifting moved the overlay one column left with the text, the text columns
+// under it (and the one left of it) are drawn again before the overlay is
+void NeopixelsClass::repairOverlay(uint8_t buffer, int xPosition)
+{
+  if (overlayLayer.width == 0) return;
+  
+  uint16_t rowMask = (1UL << tickerHeight) - 1;
+  int repairEnd = std::min(overlayLayer.x + overlayLayer.width, tickerX + tickerWidth);
+  for (int x = std::max(overlayLayer.x - 1, tickerX); x < repairEnd; x++)
+  {
+    const uint8_t* color;
+    uint16_t bits = segmentColumn(x - tickerX - xPosition, color);
+    drawColumn(frameBuffer[buffer].data(), x, bits, color);
+    columnLevel[buffer][x] = __builtin_popcount(bits & rowMask) * colorLevel(color);
+  }
+  drawOverlay(buffer);
+
+} // repairOverlay()
+
+
+// True when the LEDs do not show the current layers
+bool NeopixelsClass::layersChanged() const
+{
+  return !frameValid || (staticLayer.width > 0 && !staticLayer.drawn[frontBuffer]) || rowsChanged();
+
+} // layersChanged()
+
+
+// True when the LEDs do not show the current ticker rows
+bool NeopixelsClass::rowsChanged() const
+{
+  for (int r = 1; r < tickerRows; r++)
+  {
+    if (rows[r - 1].drawn[frontBuffer] != rows[r - 1].version) return true;
+  }
+  return false;
+
+} // rowsChanged()
+
+
+// Draw the ticker rows the buffer does not hold yet, each over the full width
+// from its own rendered strip, and count their levels
+void NeopixelsClass::drawRows(uint8_t buffer)
+{
+  int w = matrix->width();
+  uint16_t rowMask = (1UL << tickerHeight) - 1;
+  uint8_t* frame = frameBuffer[buffer].data();
+  for (int r = 1; r < tickerRows; r++)
+  {
+    TickerRow& row = rows[r - 1];
+    if (row.drawn[buffer] == row.version) continue;
+    
+    uint16_t level = colorLevel(row.color);
+    uint32_t rowLevel = 0;
+    for (int x = 0; x < w; x++)
+    {
+      int column = x - row.position;
+      uint16_t bits = (column >= 0 && column < (int)row.columns.size()) ? row.columns[column] : 0;
+      drawColumn(frame, x, bits, row.color, r * tickerHeight);
+      rowLevel += __builtin_popcount(bits & rowMask) * level;
+    }
+    row.level[buffer] = rowLevel;
+    row.drawn[buffer] = row.version;
+  }
+
+} // drawRows()
+
+
+// The buffer 'to' got a copy of buffer 'from'
+void NeopixelsClass::copyRows(uint8_t from, uint8_t to)
+{
+  for (int r = 1; r < NEO_MAX_ROWS; r++)
+  {
+    rows[r - 1].drawn[to] = rows[r - 1].drawn[from];
+    rows[r - 1].level[to] = rows[r - 1].level[from];
+  }
+
+} // copyRows()
+
+
+// The ticker rows in the buffer were overwritten, drawRows() draws them again
+void NeopixelsClass::invalidateRows(uint8_t buffer)
+{
+  for (int r = 1; r < NEO_MAX_ROWS; r++)
+  {
+    rows[r - 1].drawn[buffer] = 0;
+    rows[r - 1].level[buffer] = 0;
+  }
+
+} // invalidateRows()
+
+
+// Write the front buffer through levelLut into the Adafruit_NeoPixel buffer
+// and send that to the LEDs. With RMT output it is sent from the interrupt
+// while the next frame is built, only this pass waits for the previous frame.
+void NeopixelsClass::sendFrontBuffer()
+{
+  const std::vector<uint8_t>& front = frameBuffer[frontBuffer];
+  uint8_t* pixels = matrix->getPixels();
+  if (pixels == nullptr || front.empty()) return;
+  
+  updatePowerLevel();
+  if (lutBrightness != brightness || lutPowerLevel != powerLevel || lutFadeLevel != fadeLevel || lutGamma != gamma)
+  {
+    buildLevelLut();
+    outputsValid = false;
+  }
+  
+#if ESP_IDF_VERSION_MAJOR < 5
+  if (rmtOutput)
+  {
+    // The LEDs show the previous front buffer, which is the back buffer now
+    // (or still the front buffer). Pins whose part of it did not change are
+    // not sent again, the others are sent at the same time.
+    const uint8_t* previous = frameBuffer[frontBuffer ^ 1].data();
+    for (const PanelOutput& output : outputs)
+    {
+      if (outputsValid && !dithering
+          && memcmp(front.data() + output.offset, previous + output.offset, output.size) == 0) continue;
+      
+      rmt_wait_tx_done((rmt_channel_t)output.channel, portMAX_DELAY);
+      applyLevelLut(front.data() + output.offset, pixels + output.offset, output.size);
+      if (fadeLevel < 256) applyFadeLut(front.data(), pixels, output.offset, output.size);
+      rmt_write_sample((rmt_channel_t)output.channel, pixels + output.offset, output.size, false);
+    }
+    outputsValid = true;
+    if (frameSink) captureFrame(pixels);
+    return;
+  }
+#endif
+  
+  // show() has interrupts off for the whole frame, an unchanged frame is not sent
+  if (outputsValid && !dithering && memcmp(front.data(), frameBuffer[frontBuffer ^ 1].data(), front.size()) == 0) return;
+  
+  applyLevelLut(front.data(), pixels, front.size());
+  if (fadeLevel < 256) applyFadeLut(front.data(), pixels, 0, front.size());
+  if (frameSink) captureFrame(pixels);
+  matrix->show();
+  outputsValid = true;
+
+} // sendFrontBuffer()
+
+
+// Hand the frame as the LEDs get it (after gamma, brightness and dithering)
+// to the frame sink. Runs in the render task, the sink must be quick.
+void NeopixelsClass::captureFrame(const uint8_t* pixels)
+{
+  int w = matrix->width();
+  int h = matrix->height();
+  uint8_t rOffset = (pixelType >> 4) & 3;
+  uint8_t gOffset = (pixelType >> 2) & 3;
+  uint8_t bOffset =  pixelType       & 3;
+  
+  if (virtualMatrix.getWidth() != w || virtualMatrix.getHeight() != h) virtualMatrix.resize(w, h);
+  for (int y = 0; y < h; y++)
+  {
+    for (int x = 0; x < w; x++)
+    {
+      const uint8_t* pixel = pixels + pixelMap[y * w + x] * bytesPerPixel;
+      virtualMatrix.setPixel(x, y, pixel[rOffset], pixel[gOffset], pixel[bOffset]);
+    }
+  }
+  frameSink(virtualMatrix);
+
+} // captureFrame()
+
+
+// Colour value -> LED value in 8.8 fixed point: gamma corrected and scaled by
+// the brightness the way Adafruit_NeoPixel::setBrightness() does (and by
+// powerLevel over the power budget). fadeLut is also scaled by fadeLevel
+// during PA_FADE. The float math is only done when the gamma changes, the
+// scaling is integer math.
+void NeopixelsClass::buildLevelLut()
+{
+  if (lutGamma != gamma)
+  {
+    for (int c = 0; c < 256; c++)
+    {
+      float level = (gamma == 1.0f) ? c : powf(c / 255.0f, gamma) * 255.0f;
+      gammaLut[c] = (uint16_t)(level * 256.0f + 0.5f);
+    }
+    // A colour scaled by blendWeight[n] gives n/16 of its light
+    for (int n = 0; n <= NEO_SUBPIXEL_STEPS; n++)
+    {
+      blendWeight[n] = (uint16_t)(powf((float)n / NEO_SUBPIXEL_STEPS, 1.0f / gamma) * 256.0f + 0.5f);
+    }
+    lutGamma = gamma;
+    measureFrame(0);
+    measureFrame(1);
+    invalidateRows(0);   // their levels are counted when they are drawn
+    invalidateRows(1);
+    
+    if (debug && doDebug) debugPrint("NeopixelsClass: buildLevelLut - gamma[%d.%d]", (int)gamma, (int)(gamma * 10) % 10);
+  }
+  
+  uint32_t scale     = (uint32_t)(brightness + 1) * powerLevel;        // (brightness + 1) in 8.8
+  uint32_t fadeScale = (scale * fadeLevel + 128) >> 8;
+  for (int c = 0; c < 256; c++)
+  {
+    levelLut[c] = ((uint32_t)gammaLut[c] * scale + 32768) >> 16;
+    fadeLut[c]  = ((uint32_t)gammaLut[c] * fadeScale + 32768) >> 16;
+  }
+  lutBrightness = brightness;
+  lutPowerLevel = powerLevel;
+  lutFadeLevel  = fadeLevel;
+
+} // buildLevelLut()
+
+
+// Sum of the gamma levels (0..255) of the bytes of one pixel of this colour
+uint16_t NeopixelsClass::colorLevel(const uint8_t* color)
+{
+  uint16_t level = 0;
+  for (uint8_t i = 0; i < bytesPerPixel; i++)
+  {
+    level += (gammaLut[color[i]] + 128) >> 8;
+  }
+  return level;
+
+} // colorLevel()
+
+
+// Count the column levels of a frame buffer pixel by pixel, for frames that
+// were not built column by column (effects) and after a gamma change. The
+// columns are those of the top ticker row, the others count per row.
+void NeopixelsClass::measureFrame(uint8_t buffer)
+{
+  if (pixelMap.empty()) return;
+  
+  int w = matrix->width();
+  for (int x = 0; x < w; x++)
+  {
+    columnLevel[buffer][x] = measureColumn(buffer, x);
+  }
+  sumLevels(buffer);
+
+} // measureFrame()
+
+
+uint16_t NeopixelsClass::measureColumn(uint8_t buffer, int x)
+{
+  int w = matrix->width();
+  int h = tickerHeight;
+  const uint8_t* frame = frameBuffer[buffer].data();
+  
+  uint16_t level = 0;
+  for (int y = 0; y < h; y++)
+  {
+    level += colorLevel(frame + pixelMap[y * w + x] * bytesPerPixel);
+  }
+  return level;
+
+} // measureColumn()
+
+
+void NeopixelsClass::sumLevels(uint8_t buffer)
+{
+  frameLevel[buffer] = 0;
+  for (uint16_t level : columnLevel[buffer]) frameLevel[buffer] += level;
+  for (int r = 1; r < tickerRows; r++) frameLevel[buffer] += rows[r - 1].level[buffer];
+
+} // sumLevels()
+
+
+// Estimate the current of the front buffer at the current brightness. Over
+// maxMilliAmps powerLevel drops to fit right away (the supply would sag at
+// once), under it powerLevel comes back in steps so the display does not jump.
+void NeopixelsClass::updatePowerLevel()
+{
+  // PA_FADE dims the ticker columns, the overlay columns count in full
+  uint32_t level = frameLevel[frontBuffer];
+  if (fadeLevel < 256)
+  {
+    uint32_t fading = 0;
+    for (int x = tickerX; x < tickerX + tickerWidth; x++)
+    {
+      if (x < overlayLayer.x || x >= overlayLayer.x + overlayLayer.width) fading += columnLevel[frontBuffer][x];
+    }
+    level -= fading - fading * fadeLevel / 256;
+  }
+  float ledMilliAmps = level * (brightness + 1) / 256.0f * NEO_MA_PER_CHANNEL / 255.0f;
+  uint32_t idleMilliAmps = matrix->numPixels() * NEO_MA_IDLE;
+  
+  if (maxMilliAmps <= 0)
+  {
+    powerLevel = 256;
+  }
+  else
+  {
+    float budget = (float)maxMilliAmps - idleMilliAmps;
+    uint16_t target = 256;
+    if (ledMilliAmps > budget) target = (budget > 0) ? (uint16_t)(256.0f * budget / ledMilliAmps) : 0;
+    
+    if (target < powerLevel)  powerLevel = target;
+    else                      powerLevel += (target - powerLevel + 7) / 8;
+  }
+  estimatedMilliAmps = idleMilliAmps + (uint32_t)(ledMilliAmps * powerLevel / 256.0f);
+
+} // updatePowerLevel()
+
+
+// One pass over the frame. Without dithering the 8.8 level is rounded, with
+// dithering the fraction is rounded up against a threshold that differs per
+// byte and per frame, so over 16 frames every byte averages its exact level.
+static const uint8_t ditherThresholds[16] = {  0, 128,  64, 192,  32, 160,  96, 224
+                                             ,  16, 144,  80, 208,  48, 176, 112, 240 };
+
+void NeopixelsClass::applyLevelLut(const uint8_t* src, uint8_t* dst, size_t size)
+{
+  if (!dithering)
+  {
+    for (size_t i = 0; i < size; i++)
+    {
+      dst[i] = (levelLut[src[i]] + 128) >> 8;
+    }
+    return;
+  }
+  
+  ditherPhase = (ditherPhase + 7) & 15;
+  for (size_t i = 0; i < size; i++)
+  {
+    dst[i] = (levelLut[src[i]] + ditherThresholds[(ditherPhase + i) & 15]) >> 8;
+  }
+
+} // applyLevelLut()
+
+
+// During PA_FADE the pixels of the ticker window (not the overlay on it) of
+// the LED bytes offset .. offset + size are written again through fadeLut.
+// The clock layer and the other ticker rows keep their level.
+void NeopixelsClass::applyFadeLut(const uint8_t* src, uint8_t* dst, size_t offset, size_t size)
+{
+  int w = matrix->width();
+  for (int y = 0; y < tickerHeight; y++)
+  {
+    for (int x = tickerX; x < tickerX + tickerWidth; x++)
+    {
+      size_t first = (size_t)pixelMap[y * w + x] * bytesPerPixel;
+      if (first < offset || first >= offset + size || overlayPixel(x, y)) continue;
+      for (size_t i = first; i < first + bytesPerPixel; i++)
+      {
+        uint8_t threshold = dithering ? ditherThresholds[(ditherPhase + i - offset) & 15] : 128;
+        dst[i] = (fadeLut[src[i]] + threshold) >> 8;
+      }
+    }
+  }
+
+} // applyFadeLut()
+
+
+bool NeopixelsClass::overlayPixel(int x, int y) const
+{
+  if (x < overlayLayer.x || x >= overlayLayer.x + overlayLayer.width) return false;
+  return (overlayLayer.columns[x - overlayLayer.x] >> y) & 1;
+
+} // overlayPixel()
+
+
+// Adafruit_NeoPixel::show() bit-bangs a frame with interrupts off, the RMT
+// peripheral sends it by itself. Only possible with the IDF 4 RMT driver.
+// Every pin gets a channel; a channel also uses the memory blocks of the
+// channels after it, so with more pins every channel gets fewer blocks.
+// The driver interrupt is installed in IRAM (ESP_INTR_FLAG_IRAM), so it
+// keeps refilling the channel while LittleFS, the settings or an FSmanager
+// upload write the flash. It still waits while WiFi keeps the core busy;
+// with one block (64 symbols, under 3 pixels) the channel runs empty before
+// it is refilled and the LEDs get a broken frame. At least two blocks per
+// channel, so at most 4 pins send together. More pins are refused: the
+// panels would go to the wrong chains, all of them are sent by show() on
+// neopixelPin instead.
+bool NeopixelsClass::beginRmtOutput()
+{
+#if ESP_IDF_VERSION_MAJOR < 5
+  std::vector<uint8_t> pins = panelPins.empty() ? std::vector<uint8_t>(1, neopixelPin) : panelPins;
+  if ((int)pins.size() > NEO_RMT_MAX_PINS)
+  {
+    if (debug)  debugPrint("NeopixelsClass: ERROR - %d panel pins, at most %d can be used; all panels are sent on GPIO %d"
+                                                          , (int)pins.size(), NEO_RMT_MAX_PINS, neopixelPin);
+    else     Serial.printf("NeopixelsClass: ERROR - %d panel pins, at most %d can be used; all panels are sent on GPIO %d\n"
+                                                          , (int)pins.size(), NEO_RMT_MAX_PINS, neopixelPin);
+    return false;
+  }
+  int count = std::min((int)pins.size(), panels);
+  int memBlocks = std::min(NEO_RMT_MEM_BLOCKS, NEO_RMT_CHANNELS / count);
+  size_t panelBytes = frameBuffer[0].size() / panels;
+  
+  for (int i = 0; i < count; i++)
+  {
+    int firstPanel = (i * panels) / count;
+    int nextPanel  = ((i + 1) * panels) / count;
+    PanelOutput output = {pins[i], (uint8_t)(i * memBlocks), firstPanel * panelBytes, (nextPanel - firstPanel) * panelBytes};
+    
+    rmt_config_t config = RMT_DEFAULT_CONFIG_TX((gpio_num_t)output.pin, (rmt_channel_t)output.channel);
+    config.clk_div       = NEO_RMT_CLK_DIV;
+    config.mem_block_num = memBlocks;
+    
+    if (rmt_config(&config) != ESP_OK || rmt_driver_install(config.channel, 0, ESP_INTR_FLAG_IRAM) != ESP_OK)
+    {
+      if (debug) debugPrint("NeopixelsClass: beginRmtOutput - RMT setup failed for GPIO %d", output.pin);
+      endRmtOutput();
+      return false;
+    }
+    rmt_translator_init(config.channel, (pixelType & NEO_KHZ400) ? rmtTranslate400 : rmtTranslate800);
+    outputs.push_back(output);
+    
+    if (debug) debugPrint("NeopixelsClass: GPIO %d sends panel %d..%d on RMT channel %d"
+                                                    , output.pin, firstPanel, nextPanel - 1, output.channel);
+  }
+  rmtOutput    = true;
+  outputsValid = false;
+  return true;
+#else
+  return false;
+#endif
+
+} // beginRmtOutput()
+
+
+void NeopixelsClass::endRmtOutput()
+{
+#if ESP_IDF_VERSION_MAJOR < 5
+  for (const PanelOutput& output : outputs)
+  {
+    rmt_wait_tx_done((rmt_channel_t)output.channel, portMAX_DELAY);
+    rmt_driver_uninstall((rmt_channel_t)output.channel);
+  }
+#endif
+  outputs.clear();
+  rmtOutput = false;
+
+} // endRmtOutput()
+
+
+// Time for one pixel step. scrollDelay is in ms, but it can never be faster
+// than writing one frame to the LEDs.
+uint32_t NeopixelsClass::scrollStepUs()
+{
+  return std::max((uint32_t)scrollDelay * 1000, frameUs());
+
+} // scrollStepUs()
+
+
+// Time to write one frame to the LEDs (24 bits of 1.25us per pixel + reset),
+// with RMT the pins send together so the longest chain counts.
+uint32_t NeopixelsClass::frameUs()
+{
+  uint32_t framePixels = matrix->numPixels();
+  if (rmtOutput)
+  {
+    framePixels = 0;
+    for (const PanelOutput& output : outputs)
+    {
+      framePixels = std::max(framePixels, (uint32_t)(output.size / bytesPerPixel));
+    }
+  }
+  return framePixels * ((pixelType & NEO_KHZ400) ? 60 : 30) + 300;
+
+} // frameUs()
 
 
 int16_t NeopixelsClass::scaleValue(int16_t input
@@ -827,8 +2723,12 @@ void NeopixelsClass::debugPrint(const char* format, ...)
   vsnprintf(buffer, sizeof(buffer), format, args);
   va_end(args);
   
-  // Only print to debug stream if enabled
-  if (doDebug && debug)
+  // The render task never touches the network, it prints to Serial
+  if (doDebug && debug && inRenderTask())
+  {
+    Serial.println(buffer);
+  }
+  else if (doDebug && debug)
   {
     try
     {
@@ -1,6 +1,19 @@
 #include "ParolaClass.h"
+#include "parola_Fonts_data.h"
+#include "CodePage.h"
 #include <stdarg.h>
 
+#define RENDER_TEXT        0   // commands for the render task
+#define RENDER_INTENSITY   1
+#define RENDER_SPEED       2
+#define RENDER_CLEAR       3
+#define RENDER_STOP        4
+#define RENDER_ZONE_TEXT   5
+
+#define RENDER_QUEUE_LENGTH   8
+#define RENDER_TASK_STACK  4096
+#define RENDER_TASK_PRIORITY  5   // above the Arduino loop() task (1)
+
 ParolaClass::ParolaClass() 
 {
   // Initialize default state
@@ -17,6 +30,8 @@ ParolaClass::~ParolaClass()
 
 void ParolaClass::cleanup()
 {
+  stopRenderTask();
+  
   if (parola != nullptr)
   {
     delete parola;
@@ -36,6 +51,13 @@ bool ParolaClass::begin(uint8_t dataPin, uint8_t clkPin, uint8_t csPin, const PA
   this->clkPin  = clkPin;
   this->csPin   = csPin;
   this->numZones = config.MY_MAX_ZONES;
+  this->zoneColumns = ((numZones == 2) ? config.MY_MAX_DEVICES / 2 : config.MY_MAX_DEVICES) * 8;
+  if (setupZones(config.MY_MAX_DEVICES))
+  {
+    numZones    = zones.size();
+    zoneColumns = zones[0].columns;
+  }
+  bigFont = (zones.empty() && numZones == 2);
   
   debugPrint("ParolaClass::begin() - dataPin[%d], clkPin[%d], csPin[%d], MAX_DEVICES[%d], ZONES[%d]", 
              dataPin, clkPin, csPin, config.MY_MAX_DEVICES, config.MY_MAX_ZONES);
@@ -88,13 +110,13 @@ bool ParolaClass::begin(uint8_t dataPin, uint8_t clkPin, uint8_t csPin, const PA
     }
     
     // Initialize the display
-    if (!parola->begin(config.MY_MAX_ZONES))
+    if (!parola->begin(numZones))
     {
       debugPrint("ParolaClass::begin(MY_MAX_ZONES) - Failed to initialize MD_Parola");
       cleanup();
       return false;
     }
-    if (config.MY_MAX_ZONES == 2)
+    if (bigFont)
     {
       parola->displaySuspend(true);  // <--- Freeze display updates
       
@@ -124,8 +146,14 @@ bool ParolaClass::begin(uint8_t dataPin, uint8_t clkPin, uint8_t csPin, const PA
     }
     else
     {
-      parola->setFont(nullptr);  // Standaard font
+      for (uint8_t z = 0; z < zones.size(); z++)
+      {
+        parola->setZone(z, zones[z].config.firstDevice, zones[z].config.lastDevice);
+      }
+      parola->setFont(ExtASCII);  // ASCII + Windows-1252 (CodePage.h)
     }
+    loadCharColumns(bigFont ? BigFont : ExtASCII);
+    addWeatherChars();
 
     // Set the display configuration
     // Set animation speed
@@ -148,8 +176,62 @@ bool ParolaClass::begin(uint8_t dataPin, uint8_t clkPin, uint8_t csPin, const PA
 } // begin()
 
 
+// Zones with texts of their own, each a range of modules. Must be set before
+// begin(), an empty list gives the usual one (or two, double height) zone(s).
+void ParolaClass::setZones(const std::vector<ParolaZone> &zones)
+{
+  zoneConfig = zones;
+  debugPrint("ParolaClass::setZones() - [%d] zone(s)", zoneConfig.size());
+
+} // setZones()
+
+
+// The zones of setZones() for a chain of numDevices modules, with their text
+// buffers. False (and no zones) when a zone is not on the chain or overlaps another.
+bool ParolaClass::setupZones(uint8_t numDevices)
+{
+  zones.clear();
+  if (zoneConfig.empty()) return false;
+  
+  if (zoneConfig.size() > MAX_ZONES)
+  {
+    debugPrint("ParolaClass::setupZones() - [%d] zones, at most [%d]", zoneConfig.size(), MAX_ZONES);
+    return false;
+  }
+  for (size_t z = 0; z < zoneConfig.size(); z++)
+  {
+    const ParolaZone& zone = zoneConfig[z];
+    bool valid = (zone.firstDevice <= zone.lastDevice && zone.lastDevice < numDevices);
+    for (size_t other = 0; other < z && valid; other++)
+    {
+      valid = (zone.lastDevice < zoneConfig[other].firstDevice || zone.firstDevice > zoneConfig[other].lastDevice);
+    }
+    if (!valid)
+    {
+      debugPrint("ParolaClass::setupZones() - Zone [%d] (modules %d-%d) does not fit, using one zone"
+                                                  , z, zone.firstDevice, zone.lastDevice);
+      return false;
+    }
+  }
+  
+  zones.resize(zoneConfig.size());
+  for (size_t z = 0; z < zones.size(); z++)
+  {
+    ZoneState& state = zones[z];
+    state.config  = zoneConfig[z];
+    state.columns = (state.config.lastDevice - state.config.firstDevice + 1) * 8;
+    state.speed   = scaleValue(state.config.speed, 0, 100, 50, 4);
+  }
+  debugPrint("ParolaClass::setupZones() - [%d] zones", zones.size());
+  return true;
+
+} // setupZones()
+
+
 void ParolaClass::setScrollSpeed(int16_t newSpeed)
 {
+  if (postCommand(RENDER_SPEED, newSpeed)) return;
+  
   // Update the speed in the display configuration
   displayConfig.speed = scaleValue(newSpeed, 0, 100, 50, 4);
   if (debug && doDebug)
@@ -157,11 +239,13 @@ void ParolaClass::setScrollSpeed(int16_t newSpeed)
     debugPrint("ParolaClass: setScrollspeed to (%d)[%d]", newSpeed, displayConfig.speed);
   }
 
-  // If initialized, update the speed in the parola object
+  // If initialized, update the speed in the parola object (with zones of
+  // their own only zone 0, the others keep their speed)
   if (initialized && parola != nullptr)
   {
     //-- High Value is slow scrolling, Low Value is fast scrolling
-    parola->setSpeed((displayConfig.speed));
+    if (zones.empty())  parola->setSpeed((displayConfig.speed));
+    else                parola->setSpeed(0, displayConfig.speed);
   }
   
   debugPrint("ParolaClass::setScrollSpeed() - Speed -> updated to [%d]", displayConfig.speed);
@@ -171,6 +255,8 @@ void ParolaClass::setScrollSpeed(int16_t newSpeed)
 
 void ParolaClass::setIntensity(int16_t newIntensity)
 {
+  if (postCommand(RENDER_INTENSITY, newIntensity)) return;
+  
   int16_t intensity = scaleValue(newIntensity, 0, 100, 0, 15);
   if (debug && doDebug)
   {
@@ -238,7 +324,16 @@ void ParolaClass::setDisplayConfig(const DisplayConfig &config)
 
 textEffect_t ParolaClass::getRandomEffect()
 {
-  if (effectList.empty())
+  return getRandomEffect(effectList);
+
+} // getRandomEffect()
+
+
+// A random effect from 'effects', an empty list uses the setRandomEffects() list
+textEffect_t ParolaClass::getRandomEffect(const std::vector<uint8_t> &effects)
+{
+  const std::vector<uint8_t> &list = effects.empty() ? effectList : effects;
+  if (list.empty())
   {
     // Default to scroll left if no effects are defined
     debugPrint("ParolaClass::getRandomEffect() - No effects defined, using PA_SCROLL_RIGHT");
@@ -246,14 +341,15 @@ textEffect_t ParolaClass::getRandomEffect()
   }
   
   // Get a random effect from the list
-  size_t index = random(0, effectList.size());
-  if (index >= effectList.size())
+  size_t index = random(0, list.size());
+  if (index >= list.size())
   {
     index = 0; // Safety check
   }
   
-  return static_cast<textEffect_t>(effectList[index]);
-}
+  return static_cast<textEffect_t>(list[index]);
+
+} // getRandomEffect()
 
 
 const char* ParolaClass::setHighBits(const std::string &text)
@@ -271,6 +367,85 @@ const char* ParolaClass::setHighBits(const std::string &text)
 } // setHighBits()
 
 
+// Register the weather sprites as user characters. With one zone a sprite is
+// one character, with two zones it is scaled up 2x to the double height font:
+// the lower half (ZONE_LOWER) and the upper half (ZONE_UPPER, code | 0x80)
+void ParolaClass::addWeatherChars()
+{
+  const WeatherSprite* sprites = weatherSprites();
+  
+  for (uint8_t s = 0; s < WEATHER_SPRITES; s++)
+  {
+    const WeatherSprite& sprite = sprites[s];
+    uint8_t* lower = weatherChars[s][0];
+    uint8_t* upper = weatherChars[s][1];
+    
+    charColumns[WEATHER_ICON_CHAR + s] = (bigFont ? 2 : 1) * sprite.width;
+    
+    if (!bigFont)
+    {
+      lower[0] = sprite.width;
+      memcpy(&lower[1], sprite.columns, sprite.width);
+      parola->addChar(WEATHER_ICON_CHAR + s, lower);
+      continue;
+    }
+    
+    lower[0] = upper[0] = 2 * sprite.width;
+    for (uint8_t c = 0; c < sprite.width; c++)
+    {
+      uint8_t top = 0, bottom = 0;
+      for (uint8_t row = 0; row < 8; row++)
+      {
+        if (sprite.columns[c] & (1 << (row / 2)))     top    |= (1 << row);
+        if (sprite.columns[c] & (1 << (4 + row / 2))) bottom |= (1 << row);
+      }
+      upper[1 + 2 * c] = upper[2 + 2 * c] = top;
+      lower[1 + 2 * c] = lower[2 + 2 * c] = bottom;
+    }
+    parola->addChar(ZONE_LOWER, WEATHER_ICON_CHAR + s, lower);
+    parola->addChar(ZONE_UPPER, (WEATHER_ICON_CHAR + s) | 0x80, upper);
+  }
+  
+} // addWeatherChars()
+
+
+// The font is the width of character 0, its columns, the width of
+// character 1, .. up to 255
+void ParolaClass::loadCharColumns(const uint8_t* font)
+{
+  for (uint16_t c = 0; c < 256; c++)
+  {
+    charColumns[c] = pgm_read_byte(font);
+    font += 1 + charColumns[c];
+  }
+  
+} // loadCharColumns()
+
+
+// Turn UTF-8 text into the characters of the font: every "{name}" of a known
+// weather icon becomes its user character, other characters go to the code
+// page of ExtASCII. BigFont has ASCII only, with two zones they are folded.
+void ParolaClass::prepareText(const char* text, std::string &result)
+{
+  result.clear();
+  result.reserve(strlen(text));
+  
+  size_t iconLength;
+  for (const char* p = text; *p; )
+  {
+    int8_t icon = weatherIconAt(p, iconLength);
+    if (icon >= 0)
+    {
+      result.push_back(WEATHER_ICON_CHAR + icon);
+      p += iconLength;
+    }
+    else if ((uint8_t)*p < 0x80) result.push_back(*p++);
+    else cp1252Append(utf8NextCodePoint(p), result, !bigFont);
+  }
+  
+} // prepareText()
+
+
 
 bool ParolaClass::sendNextText(const std::string &text)
 {
@@ -285,25 +460,51 @@ bool ParolaClass::sendNextText(const std::string &text)
     debugPrint("ParolaClass::sendNextText() - Warning: Empty text");
   }
   
+  if (postCommand(RENDER_TEXT, 0, text.c_str())) return true;
+  
   currentText = text;
+  prepareText(currentText.c_str(), shownText);
+  animationDone = false;
   
   // Get effects for entry and exit
   textEffect_t effectIn = PA_SCROLL_LEFT;
   textEffect_t effectOut = getRandomEffect();
+  textPosition_t align = displayConfig.align;
+  uint16_t pause = displayConfig.pauseTime;
   
-  debugPrint("ParolaClass::sendNextText() - Text: [%s], Effects: in=%d, out=%d", 
-             currentText.c_str(), effectIn, effectOut);
+  // A text that fits the zone comes in with an effect too and stands still,
+  // centred, for staticDwellMs
+  if (staticDwellMs > 0 && parola->getTextColumns(ZONE_LOWER, shownText.c_str()) <= zoneColumns)
+  {
+    effectIn = getRandomEffect();
+    if (effectIn == PA_NO_EFFECT) effectIn = PA_PRINT;
+    align = PA_CENTER;
+    pause = std::min(staticDwellMs, (uint32_t)UINT16_MAX);
+  }
+  
+  debugPrint("ParolaClass::sendNextText() - Text: [%s], Effects: in=%d, out=%d, pause=%d", 
+             currentText.c_str(), effectIn, effectOut, pause);
   
   debugPrint("ParolaClass::sendNextText() - Using %d zone(s)", numZones);
   
-  if (numZones <= 1)
+  if (!zones.empty())
+  {
+    // Zone 0 of setZones(), the other zones go on with their own texts
+    parola->displayZoneText(0, (char *)shownText.c_str(),
+                           align,
+                           displayConfig.speed,
+                           pause,
+                           effectIn, effectOut);
+    parola->displayReset(0);
+  }
+  else if (numZones <= 1)
   {
     // Single zone configuration - use displayText
     parola->displayText(
-      (char *)currentText.c_str(),
-      displayConfig.align,
+      (char *)shownText.c_str(),
+      align,
       displayConfig.speed,
-      displayConfig.pauseTime,
+      pause,
       effectIn,
       effectOut
     );
@@ -316,16 +517,16 @@ bool ParolaClass::sendNextText(const std::string &text)
     // For a 2-zone setup:
     // ZONE_LOWER 0 (bottom) gets the original text
     // ZONE_UPPER 1 (top) gets the text with high bit set for each character
-    parola->displayZoneText(ZONE_LOWER, (char *)currentText.c_str(), 
-                           displayConfig.align,
+    parola->displayZoneText(ZONE_LOWER, (char *)shownText.c_str(), 
+                           align,
                            displayConfig.speed,
-                           displayConfig.pauseTime,
+                           pause,
                            effectIn, effectOut);
     
-    parola->displayZoneText(ZONE_UPPER, setHighBits(currentText), 
-                           displayConfig.align,
+    parola->displayZoneText(ZONE_UPPER, setHighBits(shownText), 
+                           align,
                            displayConfig.speed,
-                           displayConfig.pauseTime,
+                           pause,
                            effectIn, effectOut);
     
     // Reset both zones to start the animation
@@ -340,6 +541,115 @@ bool ParolaClass::sendNextText(const std::string &text)
 } // sendNextText()
 
 
+// Text for zone 'zone' of setZones(), zone 0 is sendNextText(). It is copied
+// into the buffer of the zone (cut to PAROLA_ZONE_TEXT) and starts right away,
+// the zone callback is called when it is done.
+bool ParolaClass::sendZoneText(uint8_t zone, const char* text)
+{
+  if (!initialized || parola == nullptr)
+  {
+    debugPrint("ParolaClass::sendZoneText() - Error: Not initialized");
+    return false;
+  }
+  if (zone == 0) return sendNextText(text);
+  if (zone >= zones.size())
+  {
+    debugPrint("ParolaClass::sendZoneText() - No zone [%d]", zone);
+    return false;
+  }
+  
+  // A long text is cut before a whole UTF-8 character
+  size_t length = strlen(text);
+  if (length >= PAROLA_ZONE_TEXT)
+  {
+    length = PAROLA_ZONE_TEXT - 1;
+    while (length > 0 && ((uint8_t)text[length] & 0xC0) == 0x80) length--;
+  }
+  ZoneState &state = zones[zone];
+  portENTER_CRITICAL(&zoneMux);
+  memcpy(state.pending, text, length);
+  state.pending[length] = '\0';
+  portEXIT_CRITICAL(&zoneMux);
+  
+  if (postCommand(RENDER_ZONE_TEXT, zone)) return true;
+  
+  startZoneText(zone);
+  return true;
+
+} // sendZoneText()
+
+
+void ParolaClass::setZoneCallback(uint8_t zone, std::function<void(uint8_t, const char*)> callback)
+{
+  if (zone == 0 || zone >= zones.size())
+  {
+    debugPrint("ParolaClass::setZoneCallback() - No zone [%d] (zone 0 uses setCallback())", zone);
+    return;
+  }
+  zones[zone].onFinished = callback;
+
+} // setZoneCallback()
+
+
+// Animate the pending text of a zone, like sendNextText() with the speed and
+// effects of the zone. A text that fits stands still for staticDwellMs (or
+// PAROLA_ZONE_DWELL), so a clock zone asks for the next time every second.
+void ParolaClass::startZoneText(uint8_t zone)
+{
+  if (zone == 0 || zone >= zones.size()) return;
+  ZoneState &state = zones[zone];
+  
+  portENTER_CRITICAL(&zoneMux);
+  memcpy(state.text, state.pending, sizeof(state.text));
+  portEXIT_CRITICAL(&zoneMux);
+  
+  prepareText(state.text, preparedText);
+  size_t length = std::min(preparedText.length(), sizeof(state.shown) - 1);
+  memcpy(state.shown, preparedText.data(), length);
+  state.shown[length] = '\0';
+  
+  textEffect_t effectIn  = PA_SCROLL_LEFT;
+  textEffect_t effectOut = getRandomEffect(state.config.effects);
+  textPosition_t align   = displayConfig.align;
+  uint16_t pause = displayConfig.pauseTime;
+  if (parola->getTextColumns(zone, state.shown) <= state.columns)
+  {
+    effectIn = getRandomEffect(state.config.effects);
+    if (effectIn == PA_NO_EFFECT) effectIn = PA_PRINT;
+    align = PA_CENTER;
+    pause = std::min((staticDwellMs > 0) ? staticDwellMs : (uint32_t)PAROLA_ZONE_DWELL, (uint32_t)UINT16_MAX);
+  }
+  
+  parola->displayZoneText(zone, state.shown, align, state.speed, pause, effectIn, effectOut);
+  parola->displayReset(zone);
+  state.animating = true;
+  
+  debugPrint("ParolaClass::startZoneText() - Zone [%d]: [%s], effects: in=%d, out=%d", zone, state.text, effectIn, effectOut);
+
+} // startZoneText()
+
+
+uint16_t ParolaClass::measureText(const std::string &text)
+{
+  if (!initialized || parola == nullptr) return 0;
+
+  //-- columns (= pixels) the text takes with the font of the (lower) zone,
+  //-- counted like MD_Parola does: one column (its default spacing) between
+  //-- two characters. Called from other tasks, so only charColumns is used.
+  std::string measured;
+  prepareText(text.c_str(), measured);
+  
+  uint16_t columns = 0;
+  for (size_t i = 0; i < measured.length(); i++)
+  {
+    columns += charColumns[(uint8_t)measured[i]];
+    if (i + 1 < measured.length()) columns += 1;
+  }
+  return columns;
+
+} // measureText()
+
+
 bool ParolaClass::animateBlocking(const String &text)
 {
   if (!initialized || parola == nullptr)
@@ -353,16 +663,24 @@ bool ParolaClass::animateBlocking(const String &text)
     debugPrint("ParolaClass::animateBlocking() - Warning: Empty text");
   }
 
+  // The render task owns the display, the text just goes in the queue
+  if (renderTaskHandle != nullptr)
+  {
+    return sendNextText(text.c_str());
+  }
+
   // DEBUG: show what we're about to display
   debugPrint("ParolaClass::animateBlocking() - Text: [%s]", text.c_str());
   
   debugPrint("ParolaClass::animateBlocking() - Using %d zone(s)", numZones);
   
-  if (numZones <= 1)
+  prepareText(text.c_str(), shownText);
+  
+  if (!bigFont)
   {
     // Single zone configuration - use displayText
     parola->displayText(
-      (char *)text.c_str(),
+      (char *)shownText.c_str(),
       displayConfig.align,
       5,  // Fixed speed for blocking animation
       displayConfig.pauseTime,
@@ -382,19 +700,16 @@ bool ParolaClass::animateBlocking(const String &text)
     // Multi-zone configuration - use displayZoneText for each zone
     parola->displaySuspend(true);  // Freeze display updates while configuring
   
-    // Convert String to std::string for our setHighBits method
-    std::string stdText(text.c_str());
-    
     // For a 2-zone setup:
     // ZONE_LOWER 0 (bottom) gets the original text
     // ZONE_UPPER 1 (top) gets the text with high bit set for each character
-    parola->displayZoneText(ZONE_LOWER, (char *)text.c_str(), 
+    parola->displayZoneText(ZONE_LOWER, (char *)shownText.c_str(), 
                            displayConfig.align,
                            10,  // Fixed speed for blocking animation
                            displayConfig.pauseTime,
                            PA_SCROLL_LEFT, PA_NO_EFFECT);
     
-    parola->displayZoneText(ZONE_UPPER, setHighBits(stdText), 
+    parola->displayZoneText(ZONE_UPPER, setHighBits(shownText), 
                            displayConfig.align,
                            10,  // Fixed speed for blocking animation
                            displayConfig.pauseTime,
@@ -430,18 +745,261 @@ void ParolaClass::loop()
     return;
   }
   
+  // The render task animates, here only the callback is run (it may use LittleFS and the network)
+  if (renderTaskHandle != nullptr)
+  {
+    if (finishedPending)
+    {
+      std::string finished = finishedText;
+      finishedPending = false;
+      if (onFinished)
+      {
+        debugPrint("ParolaClass::loop() - Animation complete, calling callback");
+        FRAME_STATS_BEGIN(callbackStart);
+        onFinished(finished);
+        FRAME_STATS_END(frameStats, FRAME_PHASE_CALLBACK, callbackStart);
+      }
+    }
+    for (uint8_t z = 1; z < zones.size(); z++)
+    {
+      if (!zones[z].finishedPending) continue;
+      zones[z].finishedPending = false;
+      if (zones[z].onFinished) zones[z].onFinished(z, zones[z].text);
+    }
+    return;
+  }
+  
   // Update the display animation
-  if (parola->displayAnimate())
+  bool animationComplete = animate(true);
+  
+  if (animationComplete)
   {
     // Animation has completed, call the callback if set
     if (onFinished)
     {
       debugPrint("ParolaClass::loop() - Animation complete, calling callback");
+      FRAME_STATS_BEGIN(callbackStart);
       onFinished(currentText);
+      FRAME_STATS_END(frameStats, FRAME_PHASE_CALLBACK, callbackStart);
     }
   }
 } // loop()
 
+
+// One displayAnimate() for all zones, true when the text of sendNextText() is
+// done. The zones of setZones() that are done report to their own callback,
+// from the render task that is left to loop().
+bool ParolaClass::animate(bool triggerCallbacks)
+{
+  FRAME_STATS_BEGIN(animateStart);
+  bool animationComplete = parola->displayAnimate();
+  FRAME_STATS_END(frameStats, FRAME_PHASE_BUILD, animateStart);
+  if (frameSink) captureFrame();
+  
+  if (zones.empty()) return animationComplete;
+  
+  for (uint8_t z = 1; z < zones.size(); z++)
+  {
+    ZoneState &state = zones[z];
+    if (!state.animating || !parola->getZoneStatus(z)) continue;
+    
+    state.animating = false;
+    if (!triggerCallbacks)    state.finishedPending = true;
+    else if (state.onFinished) state.onFinished(z, state.text);
+  }
+  return parola->getZoneStatus(0);
+
+} // animate()
+
+
+void ParolaClass::tickerClear()
+{
+  if (!initialized || parola == nullptr) return;
+  
+  if (postCommand(RENDER_CLEAR)) return;
+  
+  // Zones of their own go on with their texts
+  if (zones.empty())  parola->displayClear();
+  else                parola->displayClear(0);
+
+} // tickerClear()
+
+
+// Start the task that does all display work from now on, pinned to the core
+// that does not run WiFi. The other tasks only post commands to its queue.
+bool ParolaClass::startRenderTask(uint8_t core)
+{
+  if (renderTaskHandle != nullptr) return true;
+  
+  if (!initialized || parola == nullptr)
+  {
+    debugPrint("ParolaClass::startRenderTask() - Error: Not initialized");
+    return false;
+  }
+  
+  if (renderQueue == nullptr)
+  {
+    renderQueue = xQueueCreate(RENDER_QUEUE_LENGTH, sizeof(RenderCommand));
+    if (renderQueue == nullptr)
+    {
+      debugPrint("ParolaClass::startRenderTask() - Could not create queue");
+      return false;
+    }
+  }
+  
+  finishedPending   = false;
+  renderTaskRunning = true;
+  if (xTaskCreatePinnedToCore(renderTask, "parolaRender", RENDER_TASK_STACK, this
+                                        , RENDER_TASK_PRIORITY, &renderTaskHandle, core) != pdPASS)
+  {
+    renderTaskHandle  = nullptr;
+    renderTaskRunning = false;
+    debugPrint("ParolaClass::startRenderTask() - Could not create task");
+    return false;
+  }
+  
+  debugPrint("ParolaClass::startRenderTask() - Render task started on core %d", core);
+  return true;
+
+} // startRenderTask()
+
+
+void ParolaClass::stopRenderTask()
+{
+  if (renderTaskHandle == nullptr || inRenderTask()) return;
+  
+  // Let the task finish its frame and end itself
+  RenderCommand command = {RENDER_STOP, 0, nullptr};
+  xQueueSend(renderQueue, &command, portMAX_DELAY);
+  while (renderTaskRunning)
+  {
+    vTaskDelay(1);
+  }
+  renderTaskHandle = nullptr;
+  
+  // Drop what was still queued
+  while (xQueueReceive(renderQueue, &command, 0) == pdTRUE)
+  {
+    free(command.text);
+  }
+  finishedPending = false;
+
+} // stopRenderTask()
+
+
+bool ParolaClass::inRenderTask() const
+{
+  return renderTaskHandle != nullptr && xTaskGetCurrentTaskHandle() == renderTaskHandle;
+
+} // inRenderTask()
+
+
+// Hand a command to the render task, false if the caller has to do it itself
+// (no render task or already in the render task)
+bool ParolaClass::postCommand(uint8_t type, int16_t value, const char* text)
+{
+  if (renderTaskHandle == nullptr || inRenderTask()) return false;
+  
+  RenderCommand command = {type, value, (text != nullptr) ? strdup(text) : nullptr};
+  if (xQueueSend(renderQueue, &command, pdMS_TO_TICKS(100)) != pdTRUE)
+  {
+    debugPrint("ParolaClass::postCommand() - Render queue full, command [%d] dropped", type);
+    free(command.text);
+  }
+  return true;
+
+} // postCommand()
+
+
+void ParolaClass::handleCommand(RenderCommand &command)
+{
+  switch (command.type)
+  {
+    case RENDER_TEXT:       sendNextText((command.text != nullptr) ? command.text : "");
+                            break;
+    case RENDER_INTENSITY:  setIntensity(command.value);
+                            break;
+    case RENDER_SPEED:      setScrollSpeed(command.value);
+                            break;
+    case RENDER_CLEAR:      tickerClear();
+                            break;
+    case RENDER_ZONE_TEXT:  startZoneText(command.value);
+                            break;
+  }
+  free(command.text);
+
+} // handleCommand()
+
+
+void ParolaClass::renderLoop()
+{
+  RenderCommand command;
+  
+  while (true)
+  {
+    // displayAnimate() keeps its own time, it only has to be called every tick
+    while (xQueueReceive(renderQueue, &command, 1) == pdTRUE)
+    {
+      if (command.type == RENDER_STOP) return;
+      handleCommand(command);
+    }
+    
+    // MD_Parola builds the frame in the MD_MAX72XX buffer and sends it in one update()
+    bool animationComplete = animate(false);
+    
+    if (animationComplete && !animationDone)
+    {
+      animationDone = true;
+      if (!finishedPending)
+      {
+        finishedText    = currentText;
+        finishedPending = true;
+      }
+    }
+  }
+
+} // renderLoop()
+
+
+void ParolaClass::renderTask(void* parameter)
+{
+  ParolaClass* self = static_cast<ParolaClass*>(parameter);
+  
+  self->renderLoop();
+  
+  self->renderTaskRunning = false;
+  vTaskDelete(nullptr);
+
+} // renderTask()
+
+// Read the MD_MAX72XX buffer into the virtual matrix (one row of modules, lit
+// LEDs red) and hand it to the frame sink when it differs from the last one.
+// MD_MAX72XX column 0 is the rightmost column, bit 0 the top row.
+void ParolaClass::captureFrame()
+{
+  MD_MAX72XX* mx = parola->getGraphicObject();
+  if (mx == nullptr) return;
+  
+  uint16_t columns = mx->getColumnCount();
+  if (virtualMatrix.getWidth() != columns || virtualMatrix.getHeight() != 8) virtualMatrix.resize(columns, 8);
+  
+  for (uint16_t c = 0; c < columns; c++)
+  {
+    uint8_t bits = mx->getColumn(c);
+    for (uint8_t y = 0; y < 8; y++, bits >>= 1)
+    {
+      virtualMatrix.setPixel(columns - 1 - c, y, (bits & 1) ? 255 : 0, 0, 0);
+    }
+  }
+  
+  uint32_t frameHash = virtualMatrix.hash();
+  if (frameHash == lastFrameHash) return;
+  lastFrameHash = frameHash;
+  frameSink(virtualMatrix);
+
+} // captureFrame()
+
+
 int16_t ParolaClass::scaleValue(int16_t input
   , int16_t minInValue, int16_t maxInValue
   , int16_t minOutValue, int16_t maxOutValue) 
@@ -473,7 +1031,8 @@ void ParolaClass::debugPrint(const char* format, ...)
   
   if (doDebug)
   {
-    if (debug)  debug->println(buffer);
+    // The render task never touches the network, it prints to Serial
+    if (debug && !inRenderTask())  debug->println(buffer);
     else        Serial.println(buffer);
   }
   
@@ -1,9 +1,12 @@
 #include "RSSreaderClass.h"
+#include "CodePage.h"
 #include <WiFiClientSecure.h>
 #include <HTTPClient.h>
 #include <LittleFS.h>
+#include <algorithm>
 
 #define RSS_BASE_FOLDER "/RSSfeeds"
+#define RSS_MAX_REDIRECTS 5
 
 RSSreaderClass::RSSreaderClass() 
 {
@@ -16,11 +19,12 @@ RSSreaderClass::RSSreaderClass()
   _skipWords = { "Voetbal", "Voetballer", "Voetballers", "Voetbalster", "Voetbalsters", "KNVB" };  
   //-- be aware: no debug set yes, so no print messages
   readSkipWordsFromFile();
+  readAbbreviationsFromFile();
 
 } // RSSreaderClass()
 
 
-bool RSSreaderClass::addRSSfeed(const char* url, const char* path, size_t maxFeeds) 
+bool RSSreaderClass::addRSSfeed(const char* url, const char* path, size_t weight) 
 {
   if (_activeFeedCount >= 10)
   {
@@ -32,17 +36,20 @@ bool RSSreaderClass::addRSSfeed(const char* url, const char* path, size_t maxFee
   _urls[feedIndex] = url;
   _paths[feedIndex] = path;
   _filePaths[feedIndex] = "/RSSfeed" + String(feedIndex) + ".txt";
-  _maxFeedsPerFile[feedIndex] = maxFeeds;
-  _totalMaxFeeds += maxFeeds; // Update total max feeds
+  _feedWeights[feedIndex] = weight;
+  _totalWeight += weight; // Update total weight
   _lastCheck = 0;
 
+  _redirectCounts[feedIndex] = 0;
+
   createRSSfeedFolder();
+  loadRedirect(feedIndex);
 
-  if (debug && doDebug) debug->printf("RSSreaderClass::addRSSfeed(): URL:[%s], Path:[%s], File:[%s], Max Feeds:[%d], Index: [%d]\n" 
+  if (debug && doDebug) debug->printf("RSSreaderClass::addRSSfeed(): URL:[%s], Path:[%s], File:[%s], Weight:[%d], Index: [%d]\n" 
                                                                   , _urls[feedIndex].c_str()
                                                                   , _paths[feedIndex].c_str()
                                                                   , _filePaths[feedIndex].c_str()
-                                                                  , _maxFeedsPerFile[feedIndex], feedIndex);
+                                                                  , _feedWeights[feedIndex], feedIndex);
 
   // Always open the file in "w" mode to empty it
   LittleFS.begin();
@@ -82,7 +89,9 @@ void RSSreaderClass::loop(struct tm timeNow)
     _checkingFeeds = true;
     
     // If feed 0 has already been checked, start with feed 1
+    // but make sure it still fits in its share now all feeds are known
     if (_lastFeedUpdate[0] > 0) {
+      enforceFeedShare(0);
       _feedCheckState = 1;
     } else {
       _feedCheckState = 0;
@@ -124,72 +133,297 @@ void RSSreaderClass::loop(struct tm timeNow)
 } // loop()
 
 
-String RSSreaderClass::fetchFeed(const char* host, const char* path) 
+/*
+** One GET request. Returns the body, or "Fout: ..." on a transport error.
+** 'status' gets the HTTP status code and 'location' the Location header (if any).
+*/
+String RSSreaderClass::httpGet(const String& host, const String& path, bool secure
+                                                  , int& status, String& location) 
 {
-  if (debug) debug->printf("RSSreaderClass::fetchFeed(): URL[%s], PATH[%s]\n", host, path);
+  if (debug) debug->printf("RSSreaderClass::httpGet(): %s://%s%s%s\n", secure ? "https" : "http"
+                                                  , host.c_str(), path.startsWith("/") ? "" : "/", path.c_str());
+  status = 0;
+  location = "";
+
+  WiFiClientSecure tlsClient;
+  WiFiClient       plainClient;
+  WiFiClient*      client = &plainClient;
+  if (secure)
+  {
+    tlsClient.setInsecure();  //-- we hebben geen certificaat
+    client = &tlsClient;
+  }
+  client->setTimeout(5000); // 5s timeout
 
-  WiFiClientSecure client;
-  client.setInsecure();  //-- we hebben geen certificaat
-  client.setTimeout(5000); // 5s timeout
+  //-- a redirect can point to "host:port", the Host header keeps the port
+  String   hostName = host;
+  uint16_t port     = secure ? 443 : 80;
+  int      colonPos = host.lastIndexOf(':');
+  if (colonPos > 0 && host.substring(colonPos + 1).toInt() > 0)
+  {
+    hostName = host.substring(0, colonPos);
+    port     = host.substring(colonPos + 1).toInt();
+  }
 
-  if (!client.connect(host, 443)) 
+  if (!client->connect(hostName.c_str(), port)) 
   {
-    if (debug && doDebug) debug->println("RSSreaderClass::fetchFeed(): Verbinding mislukt!");
-    return "Fout: Kon geen TLS verbinding maken";
+    if (debug && doDebug) debug->println("RSSreaderClass::httpGet(): Verbinding mislukt!");
+    return "Fout: Kon geen verbinding maken";
   }
 
-  client.println("GET /" + String(path) + " HTTP/1.1");
-  client.println("Host: " + String(host));
-  client.println("User-Agent: ESP32RSSReader/1.0");
-  client.println("Connection: close");
-  client.println();
+  client->println("GET " + String(path.startsWith("/") ? "" : "/") + path + " HTTP/1.1");
+  client->println("Host: " + host);
+  client->println("User-Agent: ESP32RSSReader/1.0");
+  client->println("Connection: close");
+  client->println();
 
-  if (debug && doDebug) debug->println("RSSreaderClass::fetchFeed(): Verzoek verzonden, wacht op antwoord...");
+  if (debug && doDebug) debug->println("RSSreaderClass::httpGet(): Verzoek verzonden, wacht op antwoord...");
 
   // Antwoord inlezen (met totale timeout)
   String response;
   uint32_t startTime = millis();
   const uint32_t maxDuration = 8000;
 
-  while ((client.connected() || client.available()) && millis() - startTime < maxDuration) 
+  while ((client->connected() || client->available()) && millis() - startTime < maxDuration) 
   {
-    if (client.available()) 
+    if (client->available()) 
     {
-      String line = client.readStringUntil('\n');
+      String line = client->readStringUntil('\n');
       response += line + "\n";
     } else {
       delay(10);
     }
   }
 
-  client.stop();
-  if (debug && doDebug) debug->println("RSSreaderClass::fetchFeed(): Verbinding gesloten");
+  client->stop();
+  if (debug && doDebug) debug->println("RSSreaderClass::httpGet(): Verbinding gesloten");
 
   // Strip headers
   int bodyIndex = response.indexOf("\r\n\r\n");
   if (bodyIndex == -1) 
   {
-    if (debug && doDebug) debug->println("RSSreaderClass::fetchFeed(): Kon body niet vinden in antwoord");
+    if (debug && doDebug) debug->println("RSSreaderClass::httpGet(): Kon body niet vinden in antwoord");
     return "Fout: HTTP headers niet correct";
   }
 
-  String xmlPayload = response.substring(bodyIndex + 4);
-  if (debug && xmlPayload.length() == 0) 
+  //-- "HTTP/1.1 301 Moved Permanently"
+  int spacePos = response.indexOf(' ');
+  if (spacePos != -1 && spacePos < bodyIndex) status = response.substring(spacePos + 1, spacePos + 4).toInt();
+
+  String headers = response.substring(0, bodyIndex);
+  String lowerHeaders = headers;
+  lowerHeaders.toLowerCase();
+  int locationPos = lowerHeaders.indexOf("\nlocation:");
+  if (locationPos != -1)
   {
-    debug->printf("RSSreaderClass::fetchFeed(): Payload length: %d\n", xmlPayload.length());
-    //debug->println(xmlPayload.substring(0, 300));
+    int endPos = headers.indexOf('\n', locationPos + 1);
+    location = headers.substring(locationPos + 10, (endPos == -1) ? headers.length() : endPos);
+    location.trim();
   }
-  if (debug && doDebug) 
+
+  return response.substring(bodyIndex + 4);
+
+} // httpGet()
+
+
+/*
+** Fetch the feed, following up to RSS_MAX_REDIRECTS redirects. A chain of
+** permanent redirects (301/308) is remembered (also on LittleFS) so the
+** next refresh goes straight to the new location.
+*/
+String RSSreaderClass::fetchFeed(uint8_t feedIndex) 
+{
+  bool   useCache = (_redirectHosts[feedIndex].length() > 0);
+  String host     = useCache ? _redirectHosts[feedIndex] : _urls[feedIndex];
+  String path     = useCache ? _redirectPaths[feedIndex] : _paths[feedIndex];
+  bool   secure   = useCache ? _redirectSecure[feedIndex] : true;
+  bool   permanent = true;
+  bool   newTarget = false;
+
+  if (debug) debug->printf("RSSreaderClass::fetchFeed(): URL[%s], PATH[%s]%s\n", host.c_str(), path.c_str()
+                                                                      , useCache ? " (cached redirect)" : "");
+
+  for (uint8_t hop = 0; hop <= RSS_MAX_REDIRECTS; hop++)
   {
-    debug->printf("RSSreaderClass::fetchFeed(): Payload length: %d\n", xmlPayload.length());
-    //debug->println(xmlPayload.substring(0, 300));
+    int    status = 0;
+    String location;
+    String xmlPayload = httpGet(host, path, secure, status, location);
+
+    if (status >= 300 && status < 400 && location.length() > 0)
+    {
+      if (hop == RSS_MAX_REDIRECTS) break;
+      if (!splitLocation(location, host, path, secure))
+      {
+        return "Fout: Ongeldige redirect [" + location + "]";
+      }
+      _redirectCounts[feedIndex]++;
+      permanent = permanent && (status == 301 || status == 308);
+      if (permanent) newTarget = true;
+      if (debug) debug->printf("RSSreaderClass::fetchFeed(): Feed[%d] HTTP %d -> [%s]\n", feedIndex, status, location.c_str());
+      continue;
+    }
+
+    //-- a transport error (no WiFi, timeout) says nothing about the target
+    if (xmlPayload.startsWith("Fout:")) return xmlPayload;
+
+    //-- a 3xx without a usable Location has no feed in its body either
+    if (status >= 300)
+    {
+      if (useCache)
+      {
+        //-- the cached target no longer works, start over from the configured URL
+        if (debug) debug->printf("RSSreaderClass::fetchFeed(): Feed[%d] cached redirect gives HTTP %d, forget it\n", feedIndex, status);
+        forgetRedirect(feedIndex);
+        return fetchFeed(feedIndex);
+      }
+      return "Fout: HTTP status " + String(status);
+    }
+
+    if (newTarget && permanent) saveRedirect(feedIndex, host, path, secure);
+
+    if (debug && xmlPayload.length() == 0) 
+    {
+      debug->printf("RSSreaderClass::fetchFeed(): Payload length: %d\n", xmlPayload.length());
+    }
+    if (debug && doDebug) 
+    {
+      debug->printf("RSSreaderClass::fetchFeed(): Payload length: %d\n", xmlPayload.length());
+      //debug->println(xmlPayload.substring(0, 300));
+    }
+    return xmlPayload;
   }
 
-  return xmlPayload;
+  if (debug) debug->printf("RSSreaderClass::fetchFeed(): Feed[%d] too many redirects\n", feedIndex);
+  return "Fout: Te veel redirects";
 
 } // fetchFeed()
 
 
+//-- "ftp://..", "mailto:..": a ':' before the first '/' or '?'
+static bool hasScheme(const String& location)
+{
+  int colonPos = location.indexOf(':');
+  int slashPos = location.indexOf('/');
+  int queryPos = location.indexOf('?');
+  return (colonPos != -1 && (slashPos == -1 || colonPos < slashPos) && (queryPos == -1 || colonPos < queryPos));
+
+} // hasScheme()
+
+
+/*
+** Resolve a Location header against the current request:
+**   "https://host[:port]/path", "http://host"  -> new host, path and scheme
+**   "//host/path"                             -> new host, same scheme
+**   "/path"                                   -> same host
+**   "feed.xml", "?page=2"                     -> relative to the current path
+** A port stays part of 'host', httpGet() splits it off.
+*/
+bool RSSreaderClass::splitLocation(const String& location, String& host, String& path, bool& secure)
+{
+  String rest;
+  if      (location.startsWith("https://")) { secure = true;  rest = location.substring(8); }
+  else if (location.startsWith("http://"))  { secure = false; rest = location.substring(7); }
+  else if (location.startsWith("//"))       { rest = location.substring(2); }
+  else if (location.startsWith("/"))        { path = location; return true; }
+  else if (location.length() == 0 || hasScheme(location)) return false;
+  else
+  {
+    //-- relative reference: replace the query or the last path segment
+    String base = path.startsWith("/") ? path : "/" + path;
+    int queryPos = base.indexOf('?');
+    if (queryPos != -1) base = base.substring(0, queryPos);
+    if (!location.startsWith("?")) base = base.substring(0, base.lastIndexOf('/') + 1);
+    path = base + location;
+    return true;
+  }
+
+  int slashPos = rest.indexOf('/');
+  int queryPos = rest.indexOf('?');
+  if (queryPos != -1 && (slashPos == -1 || queryPos < slashPos)) slashPos = queryPos;
+  host = (slashPos == -1) ? rest : rest.substring(0, slashPos);
+  path = (slashPos == -1) ? String("/") : rest.substring(slashPos);
+  if (path.startsWith("?")) path = "/" + path;
+  return (host.length() > 0);
+
+} // splitLocation()
+
+
+String RSSreaderClass::redirectFilePath(uint8_t feedIndex)
+{
+  return RSS_BASE_FOLDER "/RSSfeed" + String(feedIndex) + ".redirect";
+
+} // redirectFilePath()
+
+
+/*
+** The .redirect file holds three lines: the configured "domain|path" it
+** belongs to (so a changed setting invalidates it), the target and "https"/"http".
+*/
+void RSSreaderClass::loadRedirect(uint8_t feedIndex)
+{
+  _redirectHosts[feedIndex]  = "";
+  _redirectPaths[feedIndex]  = "";
+  _redirectSecure[feedIndex] = true;
+
+  LittleFS.begin();
+  if (!LittleFS.exists(redirectFilePath(feedIndex))) return;
+  File file = LittleFS.open(redirectFilePath(feedIndex), "r");
+  if (!file) return;
+  String source = file.readStringUntil('\n');
+  String target = file.readStringUntil('\n');
+  String scheme = file.readStringUntil('\n');
+  file.close();
+  source.trim();
+  target.trim();
+  scheme.trim();
+
+  int sep = target.indexOf('|');
+  if (source != _urls[feedIndex] + "|" + _paths[feedIndex] || sep <= 0)
+  {
+    forgetRedirect(feedIndex);
+    return;
+  }
+  _redirectHosts[feedIndex]  = target.substring(0, sep);
+  _redirectPaths[feedIndex]  = target.substring(sep + 1);
+  _redirectSecure[feedIndex] = (scheme != "http");
+  if (debug && doDebug) debug->printf("RSSreaderClass::loadRedirect(): Feed[%d] -> [%s][%s]\n", feedIndex
+                                                      , _redirectHosts[feedIndex].c_str(), _redirectPaths[feedIndex].c_str());
+
+} // loadRedirect()
+
+
+void RSSreaderClass::saveRedirect(uint8_t feedIndex, const String& host, const String& path, bool secure)
+{
+  _redirectHosts[feedIndex]  = host;
+  _redirectPaths[feedIndex]  = path;
+  _redirectSecure[feedIndex] = secure;
+
+  LittleFS.begin();
+  File file = LittleFS.open(redirectFilePath(feedIndex), "w");
+  if (!file)
+  {
+    if (debug) debug->printf("RSSreaderClass::saveRedirect(): Kan [%s] niet schrijven\n", redirectFilePath(feedIndex).c_str());
+    return;
+  }
+  file.println(_urls[feedIndex] + "|" + _paths[feedIndex]);
+  file.println(host + "|" + path);
+  file.println(secure ? "https" : "http");
+  file.close();
+  if (debug) debug->printf("RSSreaderClass::saveRedirect(): Feed[%d] moved permanently to [%s][%s]\n", feedIndex, host.c_str(), path.c_str());
+
+} // saveRedirect()
+
+
+void RSSreaderClass::forgetRedirect(uint8_t feedIndex)
+{
+  _redirectHosts[feedIndex] = "";
+  _redirectPaths[feedIndex] = "";
+  LittleFS.begin();
+  if (LittleFS.exists(redirectFilePath(feedIndex))) LittleFS.remove(redirectFilePath(feedIndex));
+
+} // forgetRedirect()
+
+
 std::vector<String> RSSreaderClass::extractTitles(const String& feed) 
 {
   std::vector<String> titles;
@@ -426,6 +660,73 @@ bool RSSreaderClass::titleExists(const String& title, const std::vector<String>&
 
 } // titleExists()
 
+size_t RSSreaderClass::getFeedByteShare(uint8_t feedIndex)
+{
+  if (feedIndex >= _activeFeedCount || _totalWeight == 0) return 0;
+
+  return (size_t)(((uint64_t)_storageBudget * _feedWeights[feedIndex]) / _totalWeight);
+
+} // getFeedByteShare()
+
+
+/*
+** Marks the newest lines (by date) that together fit in 'share' bytes.
+** A stored line costs its length plus the "\r\n" that println() adds.
+** Returns the number of bytes the kept lines will use on LittleFS.
+*/
+size_t RSSreaderClass::selectWithinShare(const std::vector<String>& lines, const std::vector<time_t>& dates
+                                         , size_t share, std::vector<bool>& keep)
+{
+  std::vector<size_t> order(lines.size());
+  for (size_t i = 0; i < order.size(); i++) order[i] = i;
+  std::stable_sort(order.begin(), order.end(), [&dates](size_t a, size_t b) { return dates[a] > dates[b]; });
+
+  keep.assign(lines.size(), false);
+  size_t usedBytes = 0;
+  for (size_t i : order)
+  {
+    size_t lineBytes = lines[i].length() + 2;
+    if (usedBytes + lineBytes > share) continue;  // a shorter (older) title may still fit
+    keep[i] = true;
+    usedBytes += lineBytes;
+  }
+  return usedBytes;
+
+} // selectWithinShare()
+
+
+void RSSreaderClass::enforceFeedShare(uint8_t feedIndex)
+{
+  std::vector<String> lines = getStoredLines(feedIndex);
+  std::vector<time_t> dates;
+  for (const auto& line : lines)
+  {
+    dates.push_back((time_t)line.substring(0, line.indexOf('|')).toInt());
+  }
+
+  std::vector<bool> keep;
+  size_t share = getFeedByteShare(feedIndex);
+  size_t usedBytes = selectWithinShare(lines, dates, share, keep);
+  _bytesPerFile[feedIndex] = usedBytes;
+  if (std::find(keep.begin(), keep.end(), false) == keep.end()) return;
+
+  if (debug) debug->printf("RSSreaderClass::enforceFeedShare(): Feed[%d] over its share of [%d] bytes, evicting oldest\n", feedIndex, share);
+  LittleFS.begin();
+  File file = LittleFS.open(RSS_BASE_FOLDER + _filePaths[feedIndex], "w");
+  if (!file) return;
+  _actFeedsPerFile[feedIndex] = 0;
+  for (size_t i = 0; i < lines.size(); i++)
+  {
+    if (!keep[i]) continue;
+    file.println(lines[i]);
+    _actFeedsPerFile[feedIndex]++;
+  }
+  file.close();
+  _currentItemIndices[feedIndex] = 0;
+
+} // enforceFeedShare()
+
+
 void RSSreaderClass::checkFeed(uint8_t feedIndex)
 {
   if (feedIndex >= _activeFeedCount)
@@ -437,7 +738,7 @@ void RSSreaderClass::checkFeed(uint8_t feedIndex)
   if (debug && doDebug) debug->printf("RSSreaderClass::checkFeed(): Checking feed [%d] [%s]\n", 
                           feedIndex, _urls[feedIndex].c_str());
                           
-  String feed = fetchFeed(_urls[feedIndex].c_str(), _paths[feedIndex].c_str());
+  String feed = fetchFeed(feedIndex);
 
   if (feed.startsWith("Fout:")) 
   {
@@ -447,6 +748,7 @@ void RSSreaderClass::checkFeed(uint8_t feedIndex)
 
   std::vector<FeedItem> feedItems = extractFeedItems(feed);
   std::vector<String> titlesToSave;
+  std::vector<time_t> titleDates;
   
   // Filter items that have sufficient words
   for (const auto& item : feedItems) 
@@ -455,15 +757,15 @@ void RSSreaderClass::checkFeed(uint8_t feedIndex)
     {
       if (debug && doDebug) debug->printf("RSSreaderClass::checkFeed(): Titel gevonden: [%s] (timestamp: [%ld])\n", 
                               item.title.c_str(), item.pubDate);
-      titlesToSave.push_back(String(item.pubDate) + "|" + item.title);
+      titlesToSave.push_back(simplifyCharacters(String(item.pubDate) + "|" + item.title));
+      titleDates.push_back(item.pubDate);
     }
   }
 
-  // Limit to _maxFeedsPerFile titles
-  while (titlesToSave.size() > _maxFeedsPerFile[feedIndex]) 
-  {
-    titlesToSave.erase(titlesToSave.begin());
-  }
+  // Keep the newest titles that fit in this feed's share of the storage budget
+  std::vector<bool> keep;
+  size_t share = getFeedByteShare(feedIndex);
+  size_t bytesToSave = selectWithinShare(titlesToSave, titleDates, share, keep);
 
   _actFeedsPerFile[feedIndex] = 0; // Reset the count for this feed
 
@@ -472,17 +774,15 @@ void RSSreaderClass::checkFeed(uint8_t feedIndex)
   File file = LittleFS.open(RSS_BASE_FOLDER + _filePaths[feedIndex], "w"); 
   if (file) 
   {    
-    for (const auto& line : titlesToSave) 
+    for (size_t i = 0; i < titlesToSave.size(); i++) 
     {
-//      simplifyCharacters(line);
-//      file.println(line);
-//      if (debug && doDebug) debug->printf("[%s]\n", line.c_str());
-      String simplifiedLine = simplifyCharacters(line);
-      file.println(simplifiedLine);
-      if (debug && doDebug) debug->printf("[%s]\n", simplifiedLine.c_str());
+      if (!keep[i]) continue;
+      file.println(titlesToSave[i]);
+      if (debug && doDebug) debug->printf("[%s]\n", titlesToSave[i].c_str());
       _actFeedsPerFile[feedIndex]++;
     }
     file.close();
+    _bytesPerFile[feedIndex] = bytesToSave;
     
     // Reset the read count for this feed when we update its contents
     // This ensures the balancing mechanism in getNextFeedItem() will work correctly
@@ -490,7 +790,9 @@ void RSSreaderClass::checkFeed(uint8_t feedIndex)
     _feedReadCounts[feedIndex] = 0;
     
     _lastFeedUpdate[feedIndex] = millis(); // Update the last feed update time
-    if (debug) debug->printf("RSSreaderClass::checkFeed(): Feed[%d] now has [%d] items\n", feedIndex, titlesToSave.size());
+    if (debug) debug->printf("RSSreaderClass::checkFeed(): Feed[%d] now has [%d] of [%d] items, [%d] of [%d] bytes\n"
+                                                  , feedIndex, _actFeedsPerFile[feedIndex], titlesToSave.size()
+                                                  , bytesToSave, share);
   } 
   else 
   {
@@ -730,6 +1032,34 @@ bool RSSreaderClass::getNextFeedItem(uint8_t& feedIndex, size_t& itemIndex)
 } // getNextFeedItem()
 
 
+/*
+** Next item for a reader with its own ReadCursor (the second NeoPixel row,
+** a Parola zone): one item of every feed with items in turn. The rotation
+** of the main ticker above is not touched, so neither skips headlines.
+*/
+bool RSSreaderClass::getNextFeedItem(ReadCursor& cursor, uint8_t& feedIndex, size_t& itemIndex)
+{
+  for (uint8_t attempt = 0; attempt < _activeFeedCount; attempt++)
+  {
+    uint8_t feed = cursor.feedIndex % _activeFeedCount;
+    cursor.feedIndex = (feed + 1) % _activeFeedCount;
+    
+    size_t itemCount = getStoredLines(feed).size();
+    if (itemCount == 0) continue;
+    if (cursor.itemIndices[feed] >= itemCount) cursor.itemIndices[feed] = 0;
+    
+    feedIndex = feed;
+    itemIndex = cursor.itemIndices[feed]++;
+    if (debug && doDebug) debug->printf("RSSreaderClass::getNextFeedItem(cursor): return Feed[%d] Item[%d]\n", feedIndex, itemIndex);
+    return true;
+  }
+  
+  if (debug) debug->println("RSSreaderClass::getNextFeedItem(cursor): No feeds have items");
+  return false;
+
+} // getNextFeedItem()
+
+
 String RSSreaderClass::checkFeedHealth(uint8_t feedNr)
 {
   if (debug && doDebug) debug->printf("RSSreaderClass::checkFeedHealth(%d): Checking feed health...\n", feedNr);
@@ -745,8 +1075,8 @@ String RSSreaderClass::checkFeedHealth(uint8_t feedNr)
   // Get the stored lines and count them
   std::vector<String> lines = getStoredLines(feedNr);
   
-  if (debug && doDebug) debug->printf("RSSreaderClass::checkFeedHealth(): Feed[%d] has %d items, max allowed: [%d]\n", 
-                          feedNr, lines.size(), _maxFeedsPerFile[feedNr]);
+  if (debug && doDebug) debug->printf("RSSreaderClass::checkFeedHealth(): Feed[%d] has %d items, [%d] of [%d] bytes\n", 
+                          feedNr, lines.size(), _bytesPerFile[feedNr], getFeedByteShare(feedNr));
   
   // Check read counts
   if (debug && doDebug) debug->printf("RSSreaderClass::checkFeedHealth(): Feed[%d] read count: [%d]\n", 
@@ -768,7 +1098,10 @@ String RSSreaderClass::checkFeedHealth(uint8_t feedNr)
   
   //-- Print statistics
   char _msg[100];
-  snprintf(_msg, sizeof(_msg), "feed[%d] has[%d] items, max Items [%d]", feedNr, lines.size(), _maxFeedsPerFile[feedNr]);
+  snprintf(_msg, sizeof(_msg), "feed[%d] has[%d] items, [%d] of [%d] bytes, [%d] redirects%s", feedNr, lines.size()
+                                                                     , _bytesPerFile[feedNr], getFeedByteShare(feedNr)
+                                                                     , _redirectCounts[feedNr]
+                                                                     , _redirectHosts[feedNr].length() ? " (moved)" : "");
   if (debug) debug->printf("RSSreaderClass::checkFeedHealth(): %s\n", _msg);
   return String(_msg);
 
@@ -809,30 +1142,30 @@ String RSSreaderClass::simplifyCharacters(const String& input)
     {"&nbsp;", " "},
     {"&#39;", "'"},
     {"&#34;", "\""},
-    {"&ndash;", "-"},
-    {"&mdash;", "-"},
-    {"&lsquo;", "'"},
-    {"&rsquo;", "'"},
-    {"&ldquo;", "\""},
-    {"&rdquo;", "\""},
-    {"&bull;", "*"},
-    {"&hellip;", "..."},
-    {"&trade;", "TM"},
-    {"&copy;", "(c)"},
-    {"&reg;", "(r)"},
-    {"&euro;", "EUR"},
-    {"&pound;", "GBP"},
-    {"&yen;", "JPY"},
-    {"&cent;", "c"},
-    {"&sect;", "S"},
-    {"&para;", "P"},
-    {"&deg;", "deg"},
-    {"&plusmn;", "+/-"},
-    {"&times;", "x"},
-    {"&divide;", "/"},
-    {"&frac14;", "1/4"},
-    {"&frac12;", "1/2"},
-    {"&frac34;", "3/4"}
+    {"&ndash;", "–"},
+    {"&mdash;", "—"},
+    {"&lsquo;", "‘"},
+    {"&rsquo;", "’"},
+    {"&ldquo;", "“"},
+    {"&rdquo;", "”"},
+    {"&bull;", "•"},
+    {"&hellip;", "…"},
+    {"&trade;", "™"},
+    {"&copy;", "©"},
+    {"&reg;", "®"},
+    {"&euro;", "€"},
+    {"&pound;", "£"},
+    {"&yen;", "¥"},
+    {"&cent;", "¢"},
+    {"&sect;", "§"},
+    {"&para;", "¶"},
+    {"&deg;", "°"},
+    {"&plusmn;", "±"},
+    {"&times;", "×"},
+    {"&divide;", "÷"},
+    {"&frac14;", "¼"},
+    {"&frac12;", "½"},
+    {"&frac34;", "¾"}
   };
   
   // Replace HTML entities
@@ -853,122 +1186,61 @@ String RSSreaderClass::simplifyCharacters(const String& input)
     String numericEntity = result.substring(pos, end + 1);
     String numStr = result.substring(pos + 2, end);
     
-    char replacement = ' ';
+    long num = 0;
     if (numStr.length() > 0) {
       if (numStr[0] == 'x' || numStr[0] == 'X') {
         // Hexadecimal entity (&#xXXXX;)
-        long num = strtol(numStr.substring(1).c_str(), NULL, 16);
-        replacement = (char)num;
+        num = strtol(numStr.substring(1).c_str(), NULL, 16);
       } else {
         // Decimal entity (&#XXXX;)
-        long num = numStr.toInt();
-        replacement = (char)num;
+        num = numStr.toInt();
       }
     }
     
+    char replacement[4] = " ";
+    if (num >= 32 && num <= 0xFFFF) utf8Encode((uint16_t)num, replacement);
+    
     result = result.substring(0, pos) + replacement + result.substring(end + 1);
-    pos += 1; // Move past the replacement character
+    pos += strlen(replacement); // Move past the replacement character
   }
   
-  // Replace accented characters
-  struct CharReplacement {
-    const char* original;
-    const char* replacement;
-  };
-  
-  const CharReplacement charReplacements[] = {
-    // Accented A
-    {"à", "a"}, {"á", "a"}, {"â", "a"}, {"ã", "a"}, {"ä", "a"}, {"å", "a"}, {"ā", "a"}, {"ă", "a"}, {"ą", "a"},
-    // Accented C
-    {"ç", "c"}, {"ć", "c"}, {"č", "c"}, {"ĉ", "c"}, {"ċ", "c"},
-    // Accented D
-    {"ð", "d"}, {"ď", "d"}, {"đ", "d"},
-    // Accented E
-    {"è", "e"}, {"é", "e"}, {"ê", "e"}, {"ë", "e"}, {"ē", "e"}, {"ĕ", "e"}, {"ė", "e"}, {"ę", "e"}, {"ě", "e"},
-    // Accented G
-    {"ğ", "g"}, {"ģ", "g"}, {"ǧ", "g"}, {"ġ", "g"},
-    // Accented H
-    {"ĥ", "h"}, {"ħ", "h"},
-    // Accented I
-    {"ì", "i"}, {"í", "i"}, {"î", "i"}, {"ï", "i"}, {"ĩ", "i"}, {"ī", "i"}, {"ĭ", "i"}, {"į", "i"}, {"ı", "i"},
-    // Accented J
-    {"ĵ", "j"},
-    // Accented K
-    {"ķ", "k"}, {"ĸ", "k"},
-    // Accented L
-    {"ĺ", "l"}, {"ļ", "l"}, {"ľ", "l"}, {"ŀ", "l"}, {"ł", "l"},
-    // Accented N
-    {"ñ", "n"}, {"ń", "n"}, {"ņ", "n"}, {"ň", "n"}, {"ŉ", "n"}, {"ŋ", "n"},
-    // Accented O
-    {"ò", "o"}, {"ó", "o"}, {"ô", "o"}, {"õ", "o"}, {"ö", "o"}, {"ø", "o"}, {"ō", "o"}, {"ŏ", "o"}, {"ő", "o"},
-    // Accented R
-    {"ŕ", "r"}, {"ŗ", "r"}, {"ř", "r"},
-    // Accented S
-    {"ś", "s"}, {"ŝ", "s"}, {"ş", "s"}, {"š", "s"}, {"ſ", "s"},
-    // Accented T
-    {"ţ", "t"}, {"ť", "t"}, {"ŧ", "t"},
-    // Accented U
-    {"ù", "u"}, {"ú", "u"}, {"û", "u"}, {"ü", "u"}, {"ũ", "u"}, {"ū", "u"}, {"ŭ", "u"}, {"ů", "u"}, {"ű", "u"}, {"ų", "u"},
-    // Accented W
-    {"ŵ", "w"},
-    // Accented Y
-    {"ý", "y"}, {"ÿ", "y"}, {"ŷ", "y"},
-    // Accented Z
-    {"ź", "z"}, {"ż", "z"}, {"ž", "z"},
-    // Special characters
-    {"æ", "ae"}, {"œ", "oe"}, {"ß", "ss"}, {"þ", "th"},
-    // Currency symbols
-    {"€", "EUR"}, {"£", "GBP"}, {"¥", "JPY"}, {"¢", "c"},
-    // Punctuation and symbols
-    {"\xAB", "\""}, {"\xBB", "\""}, {"\x84", "\""}, {"\x93", "\""}, {"\x94", "\""}, {"\x91", "'"}, {"\x92", "'"}, {"\x82", ","},
-    {"\x85", "..."}, {"\x96", "-"}, {"\x97", "-"}, {"\x95", "*"}, {"\xA9", "(c)"}, {"\xAE", "(r)"}, {"\x99", ""},
-    {"\xA7", "S"}, {"\xB6", "P"}, {"\x86", "+"}, {"\x87", "++"}, {"\x89", "%"}, {"\x8B", "<"}, {"\x9B", ">"},
-    {"\xB5", "u"}, {"\xBF", "?"}, {"\xA1", "!"}, {"\xB1", "+/-"}, {"\xD7", "x"}, {"\xF7", "/"},
-    {"\xBC", "1/4"}, {"\xBD", "1/2"}, {"\xBE", "3/4"},{"\xB0", "*"}
-  };
-  
-  // Replace special characters
-  for (const auto& replacement : charReplacements) {
-    int pos = 0;
-    while ((pos = result.indexOf(replacement.original, pos)) != -1) {
-      result = result.substring(0, pos) + replacement.replacement + result.substring(pos + strlen(replacement.original));
-      pos += strlen(replacement.replacement);
+  // Characters of the code page (Latin-1, €, typographic quotes, ..) stay
+  // UTF-8, the display classes have glyphs for them. Other accented letters
+  // lose their accent, the rest (emoji included) becomes a space. Bytes that
+  // are not UTF-8 come from a Latin-1/Windows-1252 feed and are read as that
+  // code page.
+  String cleaned;
+  cleaned.reserve(result.length());
+  char utf8[4];
+  
+  const char* p = result.c_str();
+  while (*p) {
+    uint8_t c = (uint8_t)*p;
+    if (c < 0x80) {
+      cleaned += (c < 32 || c > 126) ? ' ' : (char)c;
+      p++;
+      continue;
     }
-  }
-  
-  // Handle uppercase accented characters by converting to lowercase first
-  String upperResult = result;
-  upperResult.toUpperCase();
-  
-  if (upperResult != result) {
-    // There are uppercase characters, apply the same replacements to the uppercase version
-    String lowerResult = result;
-    lowerResult.toLowerCase();
     
-    for (int i = 0; i < result.length(); i++) {
-      if (result[i] != lowerResult[i]) {
-        // This is an uppercase character
-        char lowerChar = lowerResult[i];
-        char upperChar = result[i];
-        
-        // Check if the lowercase version was replaced
-        for (int j = 0; j < i; j++) {
-          if (lowerResult[j] == lowerChar && result[j] != upperChar) {
-            // The lowercase version was replaced, apply the same replacement to uppercase
-            result[i] = toupper(result[j]);
-            break;
-          }
-        }
-      }
+    const char* start = p;
+    uint16_t codePoint = utf8NextCodePoint(p);
+    if (codePoint == CP_UNKNOWN) {
+      p = start + 1;
+      codePoint = cp1252ToUnicode(c);
     }
-  }
-  //-- last resort --
-  for (int i = 0; i < result.length(); i++) {
-    if (result[i] < 32 || result[i] > 126) {
-      // Replace non-printable or non-ASCII characters with a space
-      result[i] = ' ';
+    
+    if (codePoint == CP_OUTSIDE) {
+      cleaned += ' ';
+    } else if (codePoint != 0 && cp1252FromUnicode(codePoint) != 0) {
+      utf8Encode(codePoint, utf8);
+      cleaned += utf8;
+    } else if (asciiFold(codePoint, utf8)) {
+      cleaned += utf8;
+    } else {
+      cleaned += ' ';
     }
   }
+  result = cleaned;
   
   // Recursively replace double spaces with single spaces
   bool hasDoubleSpace = true;
@@ -1128,6 +1400,194 @@ void RSSreaderClass::readSkipWordsFromFile()
 } // readSkipWordsFromFile()
 
 
+void RSSreaderClass::addWordStringToAbbreviations(std::string wordList)
+{
+  if (debug && doDebug) debug->printf("RSSreaderClass::addWordStringToAbbreviations(): wordList: [%s]\n", wordList.c_str());
+  size_t pos = 0;
+
+  //-- wordList looks like "Verenigde Staten=VS, minister-president=premier"
+  while (pos < wordList.length()) 
+  {
+    size_t commaPos = wordList.find(',', pos);
+    if (commaPos == std::string::npos) commaPos = wordList.length();
+
+    std::string entry = wordList.substr(pos, commaPos - pos);
+    size_t isPos = entry.find('=');
+    if (isPos != std::string::npos)
+    {
+      std::string word = entry.substr(0, isPos);
+      std::string abbreviation = entry.substr(isPos + 1);
+      size_t start = word.find_first_not_of(" \t\r\n");
+      size_t end   = word.find_last_not_of(" \t\r\n");
+      if (start != std::string::npos)
+      {
+        word = word.substr(start, end - start + 1);
+        start = abbreviation.find_first_not_of(" \t\r\n");
+        end   = abbreviation.find_last_not_of(" \t\r\n");
+        abbreviation = (start == std::string::npos) ? "" : abbreviation.substr(start, end - start + 1);
+        _abbreviations.push_back(std::make_pair(word, abbreviation));
+        if (debug && doDebug) debug->printf("RSSreaderClass::addWordStringToAbbreviations(): [%s] -> [%s]\n", word.c_str(), abbreviation.c_str());
+      }
+    }
+    pos = commaPos + 1;
+  }
+
+} // addWordStringToAbbreviations()
+
+
+void RSSreaderClass::readAbbreviationsFromFile()
+{
+  LittleFS.begin();
+  
+  if (!LittleFS.exists("/abbreviations.txt")) return;
+
+  File file = LittleFS.open("/abbreviations.txt", "r");
+  if (!file)
+  {
+    if (debug) debug->println("RSSreaderClass::readAbbreviationsFromFile(): Failed to open file");
+    else       Serial.println("RSSreaderClass::readAbbreviationsFromFile(): Failed to open file");
+    return;
+  }
+  while (file.available())
+  {
+    String line = file.readStringUntil('\n');
+    line.trim();
+    if (line.length() > 0 && line[0] != '#') addWordStringToAbbreviations(line.c_str());
+  }
+  file.close();
+
+} // readAbbreviationsFromFile()
+
+
+bool RSSreaderClass::headlineFits(const String& title)
+{
+  return (_measureText(title) <= _headlineWidth);
+
+} // headlineFits()
+
+
+/*
+** "Brand in Amsterdam (update)" or "... [video]" -> drop the last bracketed part,
+** nested brackets included
+*/
+bool RSSreaderClass::dropBracketedSuffix(String& title)
+{
+  if (title.length() < 2) return false;
+  char closing = title[title.length() - 1];
+  char opening;
+  if      (closing == ')') opening = '(';
+  else if (closing == ']') opening = '[';
+  else return false;
+
+  //-- walk back to the bracket that matches the closing one: "Titel (a (b))"
+  int openPos = -1;
+  int depth   = 0;
+  for (int i = title.length() - 1; i >= 0; i--)
+  {
+    if      (title[i] == closing) depth++;
+    else if (title[i] == opening) depth--;
+    if (depth == 0)
+    {
+      openPos = i;
+      break;
+    }
+  }
+  if (openPos <= 0) return false;   // unbalanced, or it would drop the whole title
+  title = title.substring(0, openPos);
+  title.trim();
+  return true;
+
+} // dropBracketedSuffix()
+
+
+/*
+** "Kabinet valt - NOS" or "Kabinet valt | De Telegraaf" -> "Kabinet valt"
+** Only short tails (max 3 words) count as a source, so real sentences survive.
+*/
+bool RSSreaderClass::dropSourceSuffix(String& title)
+{
+  int sepPos = title.lastIndexOf(" - ");
+  int barPos = title.lastIndexOf(" | ");
+  if (barPos > sepPos) sepPos = barPos;
+  if (sepPos <= 0) return false;
+
+  String tail = title.substring(sepPos + 3);
+  int spaces = 0;
+  for (unsigned int i = 0; i < tail.length(); i++)
+  {
+    if (tail[i] == ' ') spaces++;
+  }
+  if (spaces > 2) return false;
+
+  title = title.substring(0, sepPos);
+  title.trim();
+  return true;
+
+} // dropSourceSuffix()
+
+
+bool RSSreaderClass::abbreviateWord(String& title, const std::string& word, const std::string& abbreviation)
+{
+  String lowerTitle = title;
+  lowerTitle.toLowerCase();
+  String lowerWord = String(word.c_str());
+  lowerWord.toLowerCase();
+  if (lowerWord.length() == 0) return false;
+
+  const char* boundaries = " .,;:!?()-[]{}\"'";
+  bool replaced = false;
+  int pos = 0;
+  while ((pos = lowerTitle.indexOf(lowerWord, pos)) != -1) 
+  {
+    unsigned int endPos = pos + lowerWord.length();
+    bool isWordStart = (pos == 0 || strchr(boundaries, lowerTitle[pos-1]));
+    bool isWordEnd   = (endPos == lowerTitle.length() || strchr(boundaries, lowerTitle[endPos]));
+    if (!isWordStart || !isWordEnd)
+    {
+      pos = endPos;
+      continue;
+    }
+    title      = title.substring(0, pos) + abbreviation.c_str() + title.substring(endPos);
+    lowerTitle = lowerTitle.substring(0, pos) + abbreviation.c_str() + lowerTitle.substring(endPos);
+    pos += abbreviation.length();
+    replaced = true;
+  }
+  return replaced;
+
+} // abbreviateWord()
+
+
+/*
+** Shorten a headline, one rule at a time, until it fits in _headlineWidth
+** pixels as measured by the display (real font metrics). If it still does
+** not fit after all rules it is returned as short as we got it.
+*/
+String RSSreaderClass::fitHeadline(const String& title)
+{
+  if (_headlineWidth == 0 || !_measureText) return title;
+
+  String fitted = title;
+  if (headlineFits(fitted)) return fitted;
+
+  while (dropBracketedSuffix(fitted))
+  {
+    if (headlineFits(fitted)) break;
+  }
+  if (!headlineFits(fitted)) dropSourceSuffix(fitted);
+
+  for (const auto& abbreviation : _abbreviations)
+  {
+    if (headlineFits(fitted)) break;
+    abbreviateWord(fitted, abbreviation.first, abbreviation.second);
+  }
+
+  if (debug && doDebug) debug->printf("RSSreaderClass::fitHeadline(): [%s] -> [%s] ([%d] pixels)\n"
+                                                        , title.c_str(), fitted.c_str(), _measureText(fitted));
+  return fitted;
+
+} // fitHeadline()
+
+
 bool RSSreaderClass::hasNoSkipWords(const String& title)
 {
   // Create a lowercase copy of the title
@@ -1214,7 +1674,7 @@ String RSSreaderClass::readRSSfeed(uint8_t feedIndex, size_t itemIndex)
   {
     if (debug && doDebug) debug->printf("RSSreaderClass::readRSSfeed(): Feed[%d], Item[%d] - [%s]\n", 
                             feedIndex, itemIndex, lines[itemIndex].c_str());
-    return lines[itemIndex].substring(sep + 1);
+    return fitHeadline(lines[itemIndex].substring(sep + 1));
   }
 
   return "";
@@ -25,6 +25,9 @@ void SettingsClass::initializeSettingsContainers()
   deviceContainer.addField({"devLDRMaxWaarde", "LDR Max. Waarde (%)", "n", 0, 6, 100, 1, &devLDRMaxWaarde});
   deviceContainer.addField({"devMaxIntensiteitLeds", "Max. Intensiteit LEDS (%)", "n", 0, 1, 100, 1, &devMaxIntensiteitLeds});
   deviceContainer.addField({"devSkipWords", "Words to skip", "s", 250, 0, 0, 0, &devSkipWords});
+  deviceContainer.addField({"devHeadlineWidth", "Max. breedte RSS kop (pixels, 0=uit)", "n", 0, 0, 2000, 1, &devHeadlineWidth});
+  deviceContainer.addField({"devAbbreviations", "Afkortingen (woord=afk,...)", "s", 250, 0, 0, 0, &devAbbreviations});
+  deviceContainer.addField({"devStaticDwell", "Korte berichten stil tonen (sec, 0=uit)", "n", 0, 0, 60, 1, &devStaticDwell});
   deviceContainer.addField({"devResetWiFiPin", "Reset WiFi GPIO pin", "n", 0, 1, 23, 1, &devResetWiFiPin});
   deviceContainer.addField({"devShowLocalA", "Show Local Message with key=A", "b", 0, 0, 0, 0, &devShowLocalA});
   deviceContainer.addField({"devShowLocalB", "Show Local Message with key=B", "b", 0, 0, 0, 0, &devShowLocalB});
@@ -54,6 +57,7 @@ void SettingsClass::initializeSettingsContainers()
   parolaContainer.addField({"parolaPinDIN", "DIN/MOSI GPIO pin (0 = default[23])", "n", 0, 0, 23, 1, &parolaPinDIN});
   parolaContainer.addField({"parolaPinCLK", "CLK/SCK GPIO pin (0 = default[18])", "n",  0, 0, 23, 1, &parolaPinCLK});
   parolaContainer.addField({"parolaPinCS", "CS/SS GPIO pin (0 = default [5])", "n",     0, 0, 23, 1, &parolaPinCS});
+  parolaContainer.addField({"parolaZones", "Zones: van-tot,bron,snelheid[,effecten]; .. (leeg = Aantal rijen)", "s", 120, 0, 0, 0, &parolaZones});
   settingsContainers["parolaSettings"] = parolaContainer;
 #endif
 
@@ -64,43 +68,56 @@ void SettingsClass::initializeSettingsContainers()
   neopixelsContainer.addField({"neopixWidth", "Neopixels Width", "n", 0, 1, 128, 1, &neopixWidth});
   neopixelsContainer.addField({"neopixHeight", "Neopixels Height", "n", 0, 1, 16, 1, &neopixHeight});
   neopixelsContainer.addField({"neopixPixPerChar", "Pixels per Charackter", "n", 0, 1, 16, 1, &neopixPixPerChar});
+  neopixelsContainer.addField({"neopixPropFont", "Proportioneel font (Pixels per Charackter geldt dan niet)", "b", 0, 0, 0, 0, &neopixPropFont});
   neopixelsContainer.addField({"neopixCOLOR", "NEOPIXELS COLOR (0=RGB, 1=RBG, 2= GRB(!), 3=GBR, 4=BRG, 5=BGR)", "n", 0, 0, 5, 0, &neopixCOLOR});
   neopixelsContainer.addField({"neopixFREQ", "NEOPIXELS SIGNAL FREQ. (false=800kHz(!), true=400kjHz)", "b", 0, 0, 0, 0, &neopixFREQ});
   neopixelsContainer.addField({"neopixMATRIXTYPEV", "MATRIX TYPE (false=TOP, true=BOTTOM)", "b", 0, 0, 0, 0, &neopixMATRIXTYPEV});
   neopixelsContainer.addField({"neopixMATRIXTYPEH", "MATRIX TYPE (false=LEFT, true=RIGHT)", "b", 0, 0, 0, 0, &neopixMATRIXTYPEH});
   neopixelsContainer.addField({"neopixMATRIXORDER", "MATRIX LAYOUT (false=ROWS, true=COLUMNS)", "b", 0, 0, 0, 0, &neopixMATRIXORDER});
   neopixelsContainer.addField({"neopixMATRIXSEQUENCE", "MATRIX SEQUENCE (false=PROGRESSIVE, true=ZIGZAG)", "b", 0, 0, 0, 0, &neopixMATRIXSEQUENCE});
+  neopixelsContainer.addField({"neopixGAMMA", "Gamma x10 (10=uit, 26=standaard)", "n", 0, 10, 30, 1, &neopixGAMMA});
+  neopixelsContainer.addField({"neopixDITHER", "Dithering bij lage helderheid", "b", 0, 0, 0, 0, &neopixDITHER});
+  neopixelsContainer.addField({"neopixSubPixel", "Vloeiend scrollen (sub-pixel) bij lage snelheid", "b", 0, 0, 0, 0, &neopixSubPixel});
+  neopixelsContainer.addField({"neopixPanels", "Aantal panelen naast elkaar", "n", 0, 1, 8, 1, &neopixPanels});
+  neopixelsContainer.addField({"neopixPanelPins", "GPIO pins van de panelen (5,18,.. max. 4)", "s", 40, 0, 0, 0, &neopixPanelPins});
+  neopixelsContainer.addField({"neopixMaxMA", "Max. stroom LEDs in mA (0=geen limiet)", "n", 0, 0, 30000, 100, &neopixMaxMA});
+  neopixelsContainer.addField({"neopixClockWidth", "Klok links, aantal kolommen (0=geen klok)", "n", 0, 0, 64, 1, &neopixClockWidth});
+  neopixelsContainer.addField({"neopixClockColor", "Kleur van de klok (R,G,B)", "s", 12, 0, 0, 0, &neopixClockColor});
+  neopixelsContainer.addField({"neopixRows", "Aantal ticker regels (2 bij hoogte 16)", "n", 0, 1, 2, 1, &neopixRows});
+  neopixelsContainer.addField({"neopixRowSource", "Tweede regel (0=weerlive, 1=rssfeed)", "n", 0, 0, 1, 1, &neopixRowSource});
+  neopixelsContainer.addField({"neopixRowSpeed", "Snelheid tweede regel", "n", 0, 0, 100, 1, &neopixRowSpeed});
   settingsContainers["neopixelsSettings"] = neopixelsContainer;
 #endif
 
   // rssfeed settings
   SettingsContainer rssfeedContainer("RSSfeed Settings", "/rssFeeds.ini", "rssfeedSettings");
   rssfeedContainer.addField({"requestInterval", "Request Interval (minuten)", "n", 0, 10, 120, 1, &requestInterval});
+  rssfeedContainer.addField({"storageBudget", "Opslag voor alle feeds (KB)", "n", 0, 4, 512, 4, &storageBudget});
   rssfeedContainer.addField({"domain0", "Domain 1", "s", 32, 0, 0, 0, &domain0});
   rssfeedContainer.addField({"path0", "Path 1", "s", 64, 0, 0, 0, &path0});
-  rssfeedContainer.addField({"maxFeeds0", "Max. aantal berichten", "n", 0, 1, 254, 1, &maxFeeds0});
+  rssfeedContainer.addField({"maxFeeds0", "Gewicht (aandeel in opslag)", "n", 0, 1, 254, 1, &maxFeeds0});
   rssfeedContainer.addField({"domain1", "Domain 2", "s", 32, 0, 0, 0, &domain1});
   rssfeedContainer.addField({"path1", "Path 2", "s", 64, 0, 0, 0, &path1});
-  rssfeedContainer.addField({"maxFeeds1", "Max. aantal berichten", "n", 0, 1, 254, 1, &maxFeeds1});
+  rssfeedContainer.addField({"maxFeeds1", "Gewicht (aandeel in opslag)", "n", 0, 1, 254, 1, &maxFeeds1});
   rssfeedContainer.addField({"domain2", "Domain 3", "s", 32, 0, 0, 0, &domain2});
   rssfeedContainer.addField({"path2", "Path 3", "s", 64, 0, 0, 0, &path2});
-  rssfeedContainer.addField({"maxFeeds2", "Max. aantal berichten", "n", 0, 1, 254, 1, &maxFeeds2});
+  rssfeedContainer.addField({"maxFeeds2", "Gewicht (aandeel in opslag)", "n", 0, 1, 254, 1, &maxFeeds2});
   rssfeedContainer.addField({"domain3", "Domain 4", "s", 32, 0, 0, 0, &domain3});
   rssfeedContainer.addField({"path3", "Path 4", "s", 64, 0, 0, 0, &path3});
-  rssfeedContainer.addField({"maxFeeds3", "Max. aantal berichten", "n", 0, 1, 254, 1, &maxFeeds3});
+  rssfeedContainer.addField({"maxFeeds3", "Gewicht (aandeel in opslag)", "n", 0, 1, 254, 1, &maxFeeds3});
   rssfeedContainer.addField({"domain4", "Domain 5", "s", 32, 0, 0, 0, &domain4});
   rssfeedContainer.addField({"path4", "Path 5", "s", 64, 0, 0, 0, &path4});
-  rssfeedContainer.addField({"maxFeeds4", "Max. aantal berichten", "n", 0, 1, 254, 1, &maxFeeds4});
+  rssfeedContainer.addField({"maxFeeds4", "Gewicht (aandeel in opslag)", "n", 0, 1, 254, 1, &maxFeeds4});
   /****** if yoy need them ********
   rssfeedContainer.addField({"domain5", "Domain 6", "s", 32, 0, 0, 0, &domain5});
   rssfeedContainer.addField({"path5", "Path 6", "s", 64, 0, 0, 0, &path5});
-  rssfeedContainer.addField({"maxFeeds5", "Max. aantal berichten", "n", 0, 1, 254, 1, &maxFeeds5});
+  rssfeedContainer.addField({"maxFeeds5", "Gewicht (aandeel in opslag)", "n", 0, 1, 254, 1, &maxFeeds5});
   rssfeedContainer.addField({"domain6", "Domain 7", "s", 32, 0, 0, 0, &domain6});
   rssfeedContainer.addField({"path6", "Path 7", "s", 64, 0, 0, 0, &path6});
-  rssfeedContainer.addField({"maxFeeds6", "Max. aantal berichten", "n", 0, 1, 254, 1, &maxFeeds6});
+  rssfeedContainer.addField({"maxFeeds6", "Gewicht (aandeel in opslag)", "n", 0, 1, 254, 1, &maxFeeds6});
   rssfeedContainer.addField({"domain7", "Domain 8", "s", 32, 0, 0, 0, &domain7});
   rssfeedContainer.addField({"path7", "Path 8", "s", 64, 0, 0, 0, &path7});
-  rssfeedContainer.addField({"maxFeeds7", "Max. aantal berichten", "n", 0, 1, 254, 1, &maxFeeds7});
+  rssfeedContainer.addField({"maxFeeds7", "Gewicht (aandeel in opslag)", "n", 0, 1, 254, 1, &maxFeeds7});
   ************* if you want them *********/
   settingsContainers["rssfeedSettings"] = rssfeedContainer;
 
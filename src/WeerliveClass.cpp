@@ -10,6 +10,7 @@
 */
 
 #include "WeerliveClass.h"
+#include "WeatherSprites.h"
 
 const char *Weerlive::apiHost = "weerlive.nl";
 
@@ -439,7 +440,7 @@ const char *Weerlive::request()
         }
         else if (kv.key() == "image")
         {
-          weerliveText += " " + kv.value().as<String>();
+          weerliveText += imageText(kv.value().as<String>());
         }
         else if (kv.key() == "alarm")
         {
@@ -507,7 +508,7 @@ if (wk_verwArray.size() > 1) {
     }
     else if (kv.key() == "image")
     {
-      weerliveText += " " + kv.value().as<String>();
+      weerliveText += imageText(kv.value().as<String>());
     }
     else if (kv.key() == "max_temp")
     {
@@ -608,6 +609,23 @@ const char *Weerlive::dateToDayName(const char *date_str)
 }
 
 
+/**
+ * Turns the "image" field into text for the ticker. An image that has a
+ * weather sprite becomes "{name}", the display classes show the sprite
+ * instead of the name
+ *
+ * @param image The image name, like "zonnig" or "halfbewolkt_regen"
+ *
+ * @return The text to append, with a leading space
+ */
+String Weerlive::imageText(const String& image)
+{
+  if (weatherSpriteIndex(image.c_str(), image.length()) < 0) return " " + image;
+  
+  return String(" ") + WEATHER_ICON_OPEN + image + WEATHER_ICON_CLOSE;
+}
+
+
 /***************************************************************************
 *
 * Permission is hereby granted, free of charge, to any person obtaining a
@@ -103,16 +103,24 @@ String getWeerliveMessage()
  *
  * The returned string will contain the feed index, item index, and the RSS feed content.
  *
+ * @param cursor Read position of a reader with its own rotation (an extra
+ *               ticker row), nullptr for the main ticker
  * @return The current message from the RSS feeds
  */
-String getRSSfeedMessage()
+String getRSSfeedMessage(RSSreaderClass::ReadCursor* cursor = nullptr)
 {
   uint8_t feedIndex = 0;
   size_t itemIndex = 0;
   char rssFeedMessage[1000] = {};
 
+  auto nextFeedItem = [cursor](uint8_t& feed, size_t& item)
+  {
+    return (cursor != nullptr) ? rssReader.getNextFeedItem(*cursor, feed, item)
+                               : rssReader.getNextFeedItem(feed, item);
+  };
+
   // Get the next feed item indices
-  if (rssReader.getNextFeedItem(feedIndex, itemIndex))
+  if (nextFeedItem(feedIndex, itemIndex))
   {
     // Read the feed content
 #if defined(NEOPIXELS_DEBUG) || defined(PAROLA_DEBUG)
@@ -125,7 +133,7 @@ String getRSSfeedMessage()
                                                 , rssReader.readRSSfeed(feedIndex, itemIndex).c_str());
 #endif
     // If we get an empty message, try again with the next indices
-    if (strlen(rssFeedMessage) == 0 && rssReader.getNextFeedItem(feedIndex, itemIndex))
+    if (strlen(rssFeedMessage) == 0 && nextFeedItem(feedIndex, itemIndex))
     {
       #if defined(NEOPIXELS_DEBUG) || defined(PAROLA_DEBUG)
       snprintf(rssFeedMessage, sizeof(rssFeedMessage), "[%d][%d/%d] %s"
@@ -1543,6 +1551,14 @@ void handleMenuItem(std::string itemName)
     } else if (itemName == "SET-EXIT") {
       spa.setMessage("Main Settings: [Exit] clicked!", 5);
       spa.activatePage("Main");
+#ifdef FRAME_STATS
+    } else if (itemName == "FRAME-STATS") {
+      //-- one line per phase: count, avg, max and the histogram buckets
+      for (uint8_t phase = 0; phase < FRAME_PHASES; phase++)
+      {
+        spa.callJsFunction("queueMessageToMonitor", ticker.getFrameStats().toText(phase).c_str());
+      }
+#endif
     }
 
 } // handleMenuItem()
@@ -1590,6 +1606,17 @@ void setupMainPage()
     spa.addMenu("Main", "File");
     spa.addMenuItem("Main", "File", "FSmanager", mainCallbackFSmanager);
     spa.addMenuItem("Main", "File", "Restart espTicker32", handleMenuItem, "SET-RESTART");
+#ifdef FRAME_STATS
+    spa.addMenuItem("Main", "File", "Frame statistics", handleMenuItem, "FRAME-STATS");
+
+    //-- frame time histograms as JSON, "?reset=1" starts a new measurement
+    spa.server.on("/api/frameStats", HTTP_GET, []()
+    {
+      String json = ticker.getFrameStats().toJson();
+      if (spa.server.hasArg("reset")) ticker.resetFrameStats();
+      spa.server.send(200, "application/json", json);
+    });
+#endif
 
     //-- Add Edit menu
     spa.addMenu("Main", "Edit");
@@ -1973,9 +2000,158 @@ void listFiles(const char * dirname, int numTabs)
     }
   }
 
-} // listFiles()  
+} // listFiles()
+
+/**
+ * @brief Sets the exit effects the ticker picks from after every text.
+ *
+ * Both display classes take the MD_Parola textEffect_t ids, so Parola and
+ * NeoPixel displays use this same list. PA_NO_EFFECT is in it more often
+ * so most texts just scroll on.
+ */
+void setTickerEffects()
+{
+  ticker.setRandomEffects({
+      PA_NO_EFFECT,
+      PA_NO_EFFECT,
+      PA_NO_EFFECT,
+      PA_NO_EFFECT,
+      PA_NO_EFFECT,
+      PA_NO_EFFECT,
+      PA_NO_EFFECT,
+      PA_NO_EFFECT,
+      PA_SCROLL_UP,
+      PA_FADE,
+      PA_DISSOLVE,
+      PA_RANDOM,
+      PA_WIPE
+  });
+
+} // setTickerEffects()
 
 #ifdef USE_PAROLA
+#define ZONE_MESSAGES   0   // sources of the Parola zones (parolaZones)
+#define ZONE_WEERLIVE   1
+#define ZONE_RSSFEED    2
+#define ZONE_TIME       3
+#define ZONE_DATE       4
+#define ZONE_DATETIME   5
+
+static const char* const zoneSourceNames[] = {"messages", "weerlive", "rssfeed", "time", "date", "datetime"};
+static uint8_t parolaZoneSource[MAX_ZONES] = {0};
+
+/**
+ * @brief Read the Parola zones from the parolaZones setting
+ *
+ * Zones are separated by ';', every zone is "first-last,source,speed[,effects]":
+ * - first-last: the modules of the zone, 0 is the first module
+ * - source: messages, weerlive, rssfeed, time, date or datetime
+ * - speed: 0-100, like devTickerSpeed
+ * - effects: optional exit effects separated by '+' (none, print, up, down,
+ *   left, right, fade, dissolve, random, wipe, cursor, slice, mesh, blinds),
+ *   without them the zone uses the normal effect list
+ *
+ * The zone with source messages (else the first zone) shows the normal messages.
+ * E.g. "0-3,time,100,print;4-11,messages,50" shows the time left of the messages.
+ *
+ * @param zones The zones for ParolaClass::setZones(), empty when the setting is empty or wrong
+ */
+void readParolaZones(std::vector<ParolaZone>& zones)
+{
+  static const struct { const char* name; uint8_t effect; } effectNames[] =
+  {
+    {"none", PA_NO_EFFECT}, {"print", PA_PRINT}, {"up", PA_SCROLL_UP}, {"down", PA_SCROLL_DOWN},
+    {"left", PA_SCROLL_LEFT}, {"right", PA_SCROLL_RIGHT}, {"fade", PA_FADE}, {"dissolve", PA_DISSOLVE},
+    {"random", PA_RANDOM}, {"wipe", PA_WIPE}, {"cursor", PA_WIPE_CURSOR}, {"slice", PA_SLICE},
+    {"mesh", PA_MESH}, {"blinds", PA_BLINDS}
+  };
+  
+  zones.clear();
+  std::string zoneList = settings.parolaZones;
+  char* nextZone = nullptr;
+  for (char* entry = strtok_r(&zoneList[0], ";", &nextZone); entry != nullptr; entry = strtok_r(nullptr, ";", &nextZone))
+  {
+    int  first, last;
+    int  speed = settings.devTickerSpeed;
+    char source[16] = "";
+    char effects[64] = "";
+    if (sscanf(entry, " %d - %d , %15[^, ] , %d , %63[^ ;]", &first, &last, source, &speed, effects) < 3
+        || first < 0 || last > 255 || zones.size() == MAX_ZONES)
+    {
+      if (debug) debug->printf("readParolaZones(): zone [%s] not understood, using parolaNumZones\n", entry);
+      zones.clear();
+      return;
+    }
+    
+    uint8_t sourceIndex = 0;
+    while (sourceIndex < ZONE_DATETIME && strcasecmp(source, zoneSourceNames[sourceIndex]) != 0) sourceIndex++;
+    if (strcasecmp(source, zoneSourceNames[sourceIndex]) != 0)
+    {
+      if (debug) debug->printf("readParolaZones(): unknown source [%s], using messages\n", source);
+      sourceIndex = ZONE_MESSAGES;
+    }
+    
+    ParolaZone zone = {(uint8_t)first, (uint8_t)last, (int16_t)constrain(speed, 0, 100), {}};
+    char* nextEffect = nullptr;
+    for (char* name = strtok_r(effects, "+", &nextEffect); name != nullptr; name = strtok_r(nullptr, "+", &nextEffect))
+    {
+      for (const auto& effectName : effectNames)
+      {
+        if (strcasecmp(name, effectName.name) == 0) zone.effects.push_back(effectName.effect);
+      }
+    }
+    
+    parolaZoneSource[zones.size()] = sourceIndex;
+    zones.push_back(zone);
+    if (debug) debug->printf("readParolaZones(): zone modules [%d-%d], source [%s], speed [%d], [%d] effect(s)\n"
+                                , first, last, zoneSourceNames[sourceIndex], zone.speed, zone.effects.size());
+  }
+  
+  // Zone 0 shows the messages (sendNextText())
+  for (uint8_t z = 1; z < zones.size(); z++)
+  {
+    if (parolaZoneSource[z] != ZONE_MESSAGES) continue;
+    std::swap(zones[0], zones[z]);
+    std::swap(parolaZoneSource[0], parolaZoneSource[z]);
+    break;
+  }
+
+} // readParolaZones()
+
+
+/**
+ * @brief Send the next text of its source to a Parola zone
+ *
+ * The RSS zones share a read position of their own, so they do not take
+ * headlines away from the messages of zone 0 (or show the same one twice).
+ *
+ * @param zone The zone (1 .. the number of zones - 1, zone 0 gets nextMessage())
+ */
+void nextZoneMessage(uint8_t zone)
+{
+  static RSSreaderClass::ReadCursor zoneCursor;
+  String zoneMessage;
+
+  switch (parolaZoneSource[zone])
+  {
+    case ZONE_WEERLIVE:  zoneMessage = rssReader.simplifyCharacters(getWeerliveMessage());
+                         break;
+    case ZONE_RSSFEED:   zoneMessage = getRSSfeedMessage(&zoneCursor);
+                         break;
+    case ZONE_TIME:      zoneMessage = network->ntpGetTime();
+                         break;
+    case ZONE_DATE:      zoneMessage = network->ntpGetDateDMY();
+                         break;
+    case ZONE_DATETIME:  zoneMessage = network->ntpGetDateTimeDMY();
+                         break;
+    default:             zoneMessage = getLocalMessage();
+                         break;
+  }
+  ticker.sendZoneText(zone, zoneMessage.c_str());
+
+} // nextZoneMessage()
+
+
   /**
    * @brief Sets up the Parola display according to settings.
    *
@@ -2043,27 +2219,19 @@ void setupParolaDisplay()
                                             clkPin,
                                             csPin,
                                             config.MY_MAX_DEVICES);
+  
+  // Zones of their own (parolaZones), else one text on parolaNumZones zone(s)
+  std::vector<ParolaZone> zones;
+  readParolaZones(zones);
+  ticker.setZones(zones);
   ticker.begin(dinPin, clkPin, csPin, config);
 
   ticker.setScrollSpeed(settings.devTickerSpeed);
   ticker.setIntensity(settings.devMaxIntensiteitLeds);
+  ticker.setStaticDwell(settings.devStaticDwell * 1000);
 
   // Rest of the function remains unchanged
-  ticker.setRandomEffects({
-      PA_NO_EFFECT,
-      PA_NO_EFFECT,
-      PA_NO_EFFECT,
-      PA_NO_EFFECT,
-      PA_NO_EFFECT,
-      PA_NO_EFFECT,
-      PA_NO_EFFECT,
-      PA_NO_EFFECT,
-      PA_SCROLL_UP,
-      PA_FADE,
-      PA_DISSOLVE,
-      PA_RANDOM,
-      PA_WIPE
-  });
+  setTickerEffects();
 
   ticker.setCallback([](const std::string& finishedText) 
   {
@@ -2076,12 +2244,54 @@ void setupParolaDisplay()
     actMessage = nextMessage();
   });
 
+  // The other zones ask for their next text when theirs is done
+  for (uint8_t zone = 1; zone < ticker.getZoneCount(); zone++)
+  {
+    ticker.setZoneCallback(zone, [](uint8_t zone, const char* finishedText)
+    {
+      if (debug && doDebug) debug->printf("[ZONE %d FINISHED] %s\n", zone, finishedText);
+      nextZoneMessage(zone);
+    });
+    nextZoneMessage(zone);
+  }
+
   delay(1000);
 
 } // setupParolaDisplay()
 #endif // USE_PAROLA
 
 #ifdef USE_NEOPIXELS
+/**
+ * @brief Send the next text to an extra ticker row of the Neopixels display
+ *
+ * With neopixRows set to 2 the bottom row scrolls the Weerlive report
+ * (neopixRowSource 0) or the RSS feeds (neopixRowSource 1) on its own, at
+ * neopixRowSpeed, while the top row shows the normal messages. The row has
+ * its own colour and its own read position in the RSS feeds, the top row
+ * keeps its colours and does not skip headlines.
+ *
+ * @param row The ticker row (1 = the second row)
+ */
+void nextRowMessage(int row)
+{
+  static RSSreaderClass::ReadCursor rowCursor;
+  std::string rowMessage;
+
+  ticker.setRowSpeed(row, settings.neopixRowSpeed);
+  if (settings.neopixRowSource == 0)
+  {
+    rowMessage = rssReader.simplifyCharacters(getWeerliveMessage()).c_str();
+    ticker.sendRowText(row, rowMessage, 0, 0, 255);   // Blue
+  }
+  else
+  {
+    rowMessage = getRSSfeedMessage(&rowCursor).c_str();
+    ticker.sendRowText(row, rowMessage, 0, 255, 0);   // Green
+  }
+
+} // nextRowMessage()
+
+
 /**
  * @brief Setup the Neopixels display
  *
@@ -2147,6 +2357,19 @@ void setupNeopixelsDisplay()
   // Set matrix size
   ticker.setMatrixSize(settings.neopixWidth, settings.neopixHeight);
   
+  // More panels side by side, on their own data pins when neopixPanelPins lists them
+  std::vector<uint8_t> panelPins;
+  const char* pinList = settings.neopixPanelPins.c_str();
+  while (*pinList)
+  {
+    char* end;
+    long panelPin = strtol(pinList, &end, 10);
+    if (end == pinList) { pinList++; continue; }
+    panelPins.push_back((uint8_t)panelPin);
+    pinList = end;
+  }
+  ticker.setPanels(settings.neopixPanels, panelPins);
+  
   // Set pixel type - try different combinations if one doesn't work
   ticker.setPixelType(neopixCOLOR + neopixFREQ);  // Most common for WS2812 LEDs // NEO_GRB + NEO_KHZ800);  // Most common for WS2812 LEDs
 
@@ -2155,6 +2378,18 @@ void setupNeopixelsDisplay()
   
   // Set pixels per character
   ticker.setPixelsPerChar(settings.neopixPixPerChar);
+  ticker.setProportionalFont(settings.neopixPropFont);
+  
+  // Output stage: gamma correction and (optional) dithering for low LDR levels
+  ticker.setGamma(settings.neopixGAMMA / 10.0f);
+  ticker.setDithering(settings.neopixDITHER);
+  ticker.setSubPixelScroll(settings.neopixSubPixel);
+  ticker.setPowerBudget(settings.neopixMaxMA);
+  ticker.setRows(settings.neopixRows);
+  
+  // Exit effects, the same list as the Parola display
+  setTickerEffects();
+  ticker.setStaticDwell(settings.devStaticDwell * 1000);
   
   
   // Set display properties
@@ -2176,9 +2411,52 @@ void setupNeopixelsDisplay()
     actMessage = nextMessage(); 
   });
 
+  // Every extra ticker row asks for its next text when its queue is empty
+  ticker.setRowCallback([](int row, const std::string& finishedText)
+  {
+    if (debug && doDebug) debug->printf("[ROW %d FINISHED] %s\n", row, finishedText.c_str());
+    nextRowMessage(row);
+  });
+  for (int row = 1; row < settings.neopixRows; row++)
+  {
+    nextRowMessage(row);
+  }
+
   delay(1000);
 
 } // setupNeopixelsDisplay()
+
+
+/**
+ * @brief Keep the clock on the Neopixels display up to date
+ *
+ * With neopixClockWidth set the time (HH:MM) stands still in that many columns
+ * left of the scrolling text. Only a new time (or width) is sent to the ticker.
+ */
+void updateTickerClock()
+{
+  static uint32_t lastClockUpdate = 0;
+  static char     lastClock[6] = "";
+  static int16_t  lastWidth = 0;
+
+  if (millis() - lastClockUpdate < CLOCK_UPDATE_INTERVAL) return;
+  lastClockUpdate = millis();
+
+  char clock[6] = "";
+  if (settings.neopixClockWidth > 0 && network->ntpIsValid())
+  {
+    struct tm timeNow = network->ntpGetTmStruct();
+    strftime(clock, sizeof(clock), "%H:%M", &timeNow);
+  }
+  if (strcmp(clock, lastClock) == 0 && settings.neopixClockWidth == lastWidth) return;
+
+  snprintf(lastClock, sizeof(lastClock), "%s", clock);
+  lastWidth = settings.neopixClockWidth;
+  int red = 200, green = 200, blue = 200;
+  sscanf(settings.neopixClockColor.c_str(), "%d,%d,%d", &red, &green, &blue);
+  ticker.setStaticText(clock, settings.neopixClockWidth, red, green, blue);
+
+} // updateTickerClock()
 #endif // USE_NEOPIXELS
 
 /**
@@ -2352,6 +2630,10 @@ void setup()
 
     rssReader.setDebug(debug);
     rssReader.addWordStringToSkipWords(settings.devSkipWords.c_str());
+    rssReader.setStorageBudget((size_t)settings.storageBudget * 1024);
+    rssReader.addWordStringToAbbreviations(settings.devAbbreviations.c_str());
+    rssReader.setHeadlineWidth(settings.devHeadlineWidth);
+    rssReader.setTextMeasure([](const String& text) { return ticker.measureText(text.c_str()); });
     
     if (!settings.domain0.empty() && !settings.path0.empty() && settings.maxFeeds0 > 0) 
               rssReader.addRSSfeed(settings.domain0.c_str(), settings.path0.c_str(), settings.maxFeeds0);
@@ -2385,6 +2667,9 @@ void setup()
 
     actMessage = nextMessage();
 
+    //-- from here on the display is driven by its own task on core 1
+    ticker.startRenderTask();
+
     if (debug) debug->println("\nespTicker32: Done with setup() ..\n");
     else       Serial.println("\nespTicker32: Done with setup() ..\n");
 
@@ -2414,6 +2699,9 @@ void loop()
     else if (debug) debug->println("espTicker32: loop(): NTP is not valid");
     lastPrint = millis();
   }
+#ifdef USE_NEOPIXELS
+  updateTickerClock();
+#endif
   ticker.loop();
   readLdr.loop();
 
@@ -0,0 +1,43 @@
+#ifndef NATIVE_ADAFRUIT_GFX_H
+#define NATIVE_ADAFRUIT_GFX_H
+
+//-- Host (env:native) Adafruit_GFX: only the settings. NeopixelsClass draws
+//-- its text into its own frame buffers, it never prints through GFX.
+
+#include <Arduino.h>
+
+typedef struct GFXfont GFXfont;
+
+class Adafruit_GFX : public Print
+{
+public:
+  Adafruit_GFX(int16_t w, int16_t h) : _width(w), _height(h) {}
+  virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+  virtual void fillScreen(uint16_t color)
+  {
+    for (int16_t y = 0; y < _height; y++)
+    {
+      for (int16_t x = 0; x < _width; x++) drawPixel(x, y, color);
+    }
+  }
+  size_t write(uint8_t) override { return 1; }
+
+  void setCursor(int16_t x, int16_t y) { cursor_x = x; cursor_y = y; }
+  void setTextColor(uint16_t c) { textcolor = c; }
+  void setTextColor(uint16_t c, uint16_t) { textcolor = c; }
+  void setTextSize(uint8_t) {}
+  void setTextWrap(bool w) { wrap = w; }
+  void setFont(const GFXfont* = nullptr) {}
+  void setRotation(uint8_t r) { rotation = r & 3; }
+  int16_t width() const  { return _width; }
+  int16_t height() const { return _height; }
+
+protected:
+  int16_t  _width, _height;
+  int16_t  cursor_x = 0, cursor_y = 0;
+  uint16_t textcolor = 0xFFFF;
+  uint8_t  rotation = 0;
+  bool     wrap = true;
+};
+
+#endif // NATIVE_ADAFRUIT_GFX_H
@@ -0,0 +1,78 @@
+#ifndef NATIVE_ADAFRUIT_NEOMATRIX_H
+#define NATIVE_ADAFRUIT_NEOMATRIX_H
+
+//-- Host (env:native) Adafruit_NeoMatrix: the layout flags and the two
+//-- constructors. drawPixel() maps like one matrix of all tiles together,
+//-- NeopixelsClass builds its own pixel map and does not use it.
+
+#include <Adafruit_GFX.h>
+#include <Adafruit_NeoPixel.h>
+
+#define NEO_MATRIX_TOP         0x00
+#define NEO_MATRIX_BOTTOM      0x01
+#define NEO_MATRIX_LEFT        0x00
+#define NEO_MATRIX_RIGHT       0x02
+#define NEO_MATRIX_CORNER      0x03
+#define NEO_MATRIX_ROWS        0x00
+#define NEO_MATRIX_COLUMNS     0x04
+#define NEO_MATRIX_AXIS        0x04
+#define NEO_MATRIX_PROGRESSIVE 0x00
+#define NEO_MATRIX_ZIGZAG      0x08
+#define NEO_MATRIX_SEQUENCE    0x08
+#define NEO_TILE_TOP           0x00
+#define NEO_TILE_BOTTOM        0x10
+#define NEO_TILE_LEFT          0x00
+#define NEO_TILE_RIGHT         0x20
+#define NEO_TILE_CORNER        0x30
+#define NEO_TILE_ROWS          0x00
+#define NEO_TILE_COLUMNS       0x40
+#define NEO_TILE_AXIS          0x40
+#define NEO_TILE_PROGRESSIVE   0x00
+#define NEO_TILE_ZIGZAG        0x80
+#define NEO_TILE_SEQUENCE      0x80
+
+class Adafruit_NeoMatrix : public Adafruit_GFX, public Adafruit_NeoPixel
+{
+public:
+  Adafruit_NeoMatrix(int w, int h, uint8_t pin = 6
+                   , uint8_t matrixType = NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS
+                   , neoPixelType ledType = NEO_GRB + NEO_KHZ800)
+    : Adafruit_GFX(w, h), Adafruit_NeoPixel(w * h, pin, ledType), type(matrixType) {}
+  Adafruit_NeoMatrix(uint8_t matrixW, uint8_t matrixH, uint8_t tX, uint8_t tY, uint8_t pin = 6
+                   , uint8_t matrixType = NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS + NEO_TILE_TOP
+                                        + NEO_TILE_LEFT + NEO_TILE_ROWS
+                   , neoPixelType ledType = NEO_GRB + NEO_KHZ800)
+    : Adafruit_GFX(matrixW * tX, matrixH * tY), Adafruit_NeoPixel(matrixW * tX * matrixH * tY, pin, ledType), type(matrixType) {}
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override
+  {
+    if (x < 0 || y < 0 || x >= _width || y >= _height) return;
+    int column = (type & NEO_MATRIX_RIGHT)  ? _width - 1 - x  : x;
+    int row    = (type & NEO_MATRIX_BOTTOM) ? _height - 1 - y : y;
+    bool columns = (type & NEO_MATRIX_COLUMNS) != 0;
+    int major  = columns ? column : row;
+    int minor  = columns ? row : column;
+    int majorScale = columns ? _height : _width;
+    if ((type & NEO_MATRIX_ZIGZAG) && (major & 1)) minor = majorScale - 1 - minor;
+    setPixelColor(major * majorScale + minor, expandColor(color));
+  }
+
+  static uint16_t Color(uint8_t r, uint8_t g, uint8_t b)
+  {
+    return ((uint16_t)(r & 0xF8) << 8) | ((uint16_t)(g & 0xFC) << 3) | (b >> 3);
+  }
+
+  using Adafruit_GFX::width;
+  using Adafruit_GFX::height;
+
+private:
+  static uint32_t expandColor(uint16_t c)
+  {
+    uint8_t r = (c >> 11) & 0x1F, g = (c >> 5) & 0x3F, b = c & 0x1F;
+    return ((uint32_t)((r << 3) | (r >> 2)) << 16) | ((uint32_t)((g << 2) | (g >> 4)) << 8) | ((b << 3) | (b >> 2));
+  }
+
+  uint8_t type;
+};
+
+#endif // NATIVE_ADAFRUIT_NEOMATRIX_H
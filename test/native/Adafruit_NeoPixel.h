@@ -0,0 +1,101 @@
+#ifndef NATIVE_ADAFRUIT_NEOPIXEL_H
+#define NATIVE_ADAFRUIT_NEOPIXEL_H
+
+//-- Host (env:native) Adafruit_NeoPixel: the same pixel buffer (LED byte
+//-- order, brightness as the library scales it), show() keeps a copy of it
+//-- as the LEDs would get it.
+
+#include <Arduino.h>
+#include <vector>
+
+typedef uint16_t neoPixelType;
+
+#define NEO_RGB  ((0 << 6) | (0 << 4) | (1 << 2) | (2))
+#define NEO_RBG  ((0 << 6) | (0 << 4) | (2 << 2) | (1))
+#define NEO_GRB  ((1 << 6) | (1 << 4) | (0 << 2) | (2))
+#define NEO_GBR  ((2 << 6) | (2 << 4) | (0 << 2) | (1))
+#define NEO_BRG  ((1 << 6) | (1 << 4) | (2 << 2) | (0))
+#define NEO_BGR  ((2 << 6) | (2 << 4) | (1 << 2) | (0))
+#define NEO_WRGB ((0 << 6) | (1 << 4) | (2 << 2) | (3))
+#define NEO_RGBW ((3 << 6) | (0 << 4) | (1 << 2) | (2))
+#define NEO_GRBW ((3 << 6) | (1 << 4) | (0 << 2) | (2))
+#define NEO_KHZ800 0x0000
+#define NEO_KHZ400 0x0100
+
+class Adafruit_NeoPixel
+{
+public:
+  Adafruit_NeoPixel(uint16_t n = 0, int16_t p = 6, neoPixelType t = NEO_GRB + NEO_KHZ800) : pin(p)
+  {
+    updateType(t);
+    updateLength(n);
+  }
+  virtual ~Adafruit_NeoPixel() {}
+
+  void begin() { begun = true; }
+  void show()  { shown = pixels; shows++; }
+  bool canShow() const { return true; }
+  void setPin(int16_t p) { pin = p; }
+  int16_t getPin() const { return pin; }
+
+  void updateLength(uint16_t n)
+  {
+    numLEDs = n;
+    pixels.assign((size_t)n * bytesPerPixel, 0);
+  }
+  void updateType(neoPixelType t)
+  {
+    wOffset = (t >> 6) & 3;
+    rOffset = (t >> 4) & 3;
+    gOffset = (t >> 2) & 3;
+    bOffset = t & 3;
+    bytesPerPixel = (wOffset == rOffset) ? 3 : 4;
+  }
+
+  void setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b)
+  {
+    if (n >= numLEDs) return;
+    if (brightness)
+    {
+      r = (r * brightness) >> 8;
+      g = (g * brightness) >> 8;
+      b = (b * brightness) >> 8;
+    }
+    uint8_t* p = &pixels[(size_t)n * bytesPerPixel];
+    p[rOffset] = r;
+    p[gOffset] = g;
+    p[bOffset] = b;
+  }
+  void setPixelColor(uint16_t n, uint32_t c) { setPixelColor(n, (uint8_t)(c >> 16), (uint8_t)(c >> 8), (uint8_t)c); }
+  void fill(uint32_t c = 0, uint16_t first = 0, uint16_t count = 0)
+  {
+    uint16_t end = (count == 0 || first + count > numLEDs) ? numLEDs : first + count;
+    for (uint16_t i = first; i < end; i++) setPixelColor(i, c);
+  }
+  void clear() { std::fill(pixels.begin(), pixels.end(), 0); }
+
+  void     setBrightness(uint8_t b) { brightness = b + 1; }
+  uint8_t  getBrightness() const { return brightness - 1; }
+  uint8_t* getPixels() const { return (uint8_t*)pixels.data(); }
+  uint16_t numPixels() const { return numLEDs; }
+
+  static uint32_t Color(uint8_t r, uint8_t g, uint8_t b) { return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b; }
+  static uint8_t  gamma8(uint8_t x) { return x; }
+
+  // What show() sent last and how often
+  const std::vector<uint8_t>& getShownPixels() const { return shown; }
+  uint32_t getShowCount() const { return shows; }
+
+protected:
+  uint16_t numLEDs = 0;
+  int16_t  pin;
+  uint8_t  brightness = 0;   // 0 = full, as in the library
+  uint8_t  rOffset = 1, gOffset = 0, bOffset = 2, wOffset = 1;
+  uint8_t  bytesPerPixel = 3;
+  bool     begun = false;
+  std::vector<uint8_t> pixels;
+  std::vector<uint8_t> shown;
+  uint32_t shows = 0;
+};
+
+#endif // NATIVE_ADAFRUIT_NEOPIXEL_H
@@ -0,0 +1,193 @@
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+//-- Host (env:native) stand-in for the part of the Arduino core the display
+//-- classes use. Header only: the clock stands still until a test (or
+//-- delay()) moves it on and random() always gives the same row, so every
+//-- run renders the same frames.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <math.h>
+#include <time.h>
+#include <string>
+#include <algorithm>
+#include <functional>
+
+#define ARDUINO 10819
+#define PROGMEM
+#define IRAM_ATTR
+#define pgm_read_byte(p)  (*(const uint8_t*)(p))
+#define pgm_read_word(p)  (*(const uint16_t*)(p))
+#define pgm_read_dword(p) (*(const uint32_t*)(p))
+#define pgm_read_ptr(p)   (*(void* const*)(p))
+#define F(s)              (s)
+
+#define LOW           0
+#define HIGH          1
+#define INPUT         0x01
+#define OUTPUT        0x03
+#define INPUT_PULLUP  0x05
+#define LSBFIRST      0
+#define MSBFIRST      1
+
+typedef bool    boolean;
+typedef uint8_t byte;
+
+class String
+{
+public:
+  String() {}
+  String(const char* text) : value(text ? text : "") {}
+  String(const std::string& text) : value(text) {}
+  String(char c) : value(1, c) {}
+  String(int number) : value(std::to_string(number)) {}
+  String(unsigned int number) : value(std::to_string(number)) {}
+  String(long number) : value(std::to_string(number)) {}
+  String(unsigned long number) : value(std::to_string(number)) {}
+
+  const char*  c_str() const  { return value.c_str(); }
+  unsigned int length() const { return value.size(); }
+  bool         isEmpty() const { return value.empty(); }
+  char         charAt(unsigned int i) const { return (i < value.size()) ? value[i] : 0; }
+  char         operator[](unsigned int i) const { return charAt(i); }
+  int          indexOf(char c, unsigned int from = 0) const { return position(value.find(c, from)); }
+  int          indexOf(const String& s, unsigned int from = 0) const { return position(value.find(s.value, from)); }
+  String       substring(unsigned int from) const { return (from < value.size()) ? String(value.substr(from)) : String(); }
+  String       substring(unsigned int from, unsigned int to) const
+  {
+    if (from > to) std::swap(from, to);
+    return (from < value.size()) ? String(value.substr(from, to - from)) : String();
+  }
+  bool         startsWith(const String& s) const { return value.compare(0, s.value.size(), s.value) == 0; }
+  long         toInt() const { return atol(value.c_str()); }
+  void         trim()
+  {
+    size_t first = value.find_first_not_of(" \t\r\n");
+    size_t last  = value.find_last_not_of(" \t\r\n");
+    value = (first == std::string::npos) ? std::string() : value.substr(first, last - first + 1);
+  }
+  String&      operator+=(const String& s) { value += s.value; return *this; }
+  String&      operator+=(const char* s)   { value += s; return *this; }
+  String&      operator+=(char c)          { value += c; return *this; }
+  bool         operator==(const String& s) const { return value == s.value; }
+  bool         operator==(const char* s) const   { return value == s; }
+  bool         operator!=(const String& s) const { return value != s.value; }
+
+private:
+  static int position(size_t p) { return (p == std::string::npos) ? -1 : (int)p; }
+  std::string value;
+};
+
+inline String operator+(const String& a, const String& b) { String s(a); s += b; return s; }
+inline String operator+(const String& a, const char* b)   { String s(a); s += b; return s; }
+inline String operator+(const char* a, const String& b)   { String s(a); s += b; return s; }
+
+// Output goes nowhere, unless NATIVE_VERBOSE is defined
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c)
+  {
+#ifdef NATIVE_VERBOSE
+    fputc(c, stdout);
+#endif
+    return 1;
+  }
+  virtual size_t write(const uint8_t* buffer, size_t size)
+  {
+    for (size_t i = 0; i < size; i++) write(buffer[i]);
+    return size;
+  }
+  size_t print(const char* s)     { return write((const uint8_t*)s, strlen(s)); }
+  size_t print(const String& s)   { return print(s.c_str()); }
+  size_t print(char c)            { return write((uint8_t)c); }
+  size_t print(int n)             { return printf("%d", n); }
+  size_t print(unsigned int n)    { return printf("%u", n); }
+  size_t print(long n)            { return printf("%ld", n); }
+  size_t print(unsigned long n)   { return printf("%lu", n); }
+  size_t print(double n)          { return printf("%.2f", n); }
+  size_t println()                { return print("\r\n"); }
+  template <class T> size_t println(const T& v) { size_t n = print(v); return n + println(); }
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)))
+  {
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    return (n > 0) ? write((const uint8_t*)buffer, std::min((size_t)n, sizeof(buffer) - 1)) : 0;
+  }
+  void flush() {}
+};
+
+class Stream : public Print
+{
+public:
+  virtual int available() { return 0; }
+  virtual int read()      { return -1; }
+  virtual int peek()      { return -1; }
+};
+
+class HardwareSerial : public Stream
+{
+public:
+  void begin(unsigned long) {}
+  operator bool() const { return true; }
+};
+
+inline HardwareSerial& nativeSerial() { static HardwareSerial serial; return serial; }
+#define Serial nativeSerial()
+
+// Host clock in microseconds, moved on by the tests
+inline uint64_t& nativeMicros() { static uint64_t now = 1; return now; }
+inline void nativeAdvanceMicros(uint32_t us) { nativeMicros() += us; }
+
+inline unsigned long micros() { return (unsigned long)nativeMicros(); }
+inline unsigned long millis() { return (unsigned long)(nativeMicros() / 1000); }
+inline void delay(unsigned long ms) { nativeMicros() += (uint64_t)ms * 1000; }
+inline void delayMicroseconds(unsigned int us) { nativeMicros() += us; }
+inline void yield() {}
+
+// A 240MHz CPU on the host clock (FrameStats counts cycles)
+class EspClass
+{
+public:
+  uint32_t getCpuFreqMHz() { return 240; }
+  uint32_t getCycleCount() { return (uint32_t)(nativeMicros() * 240); }
+  uint32_t getFreeHeap()   { return 200000; }
+  void     restart()       {}
+};
+inline EspClass& nativeEsp() { static EspClass esp; return esp; }
+#define ESP nativeEsp()
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline int  digitalRead(uint8_t) { return LOW; }
+inline int  analogRead(uint8_t) { return 0; }
+
+// Same row of numbers on every host (a 32 bit LCG, not the C library rand())
+inline uint32_t& nativeRandomState() { static uint32_t state = 1; return state; }
+inline void randomSeed(unsigned long seed) { nativeRandomState() = (uint32_t)seed; }
+inline long random(long howBig)
+{
+  if (howBig <= 0) return 0;
+  nativeRandomState() = nativeRandomState() * 1664525u + 1013904223u;
+  return (long)((nativeRandomState() >> 8) % (uint32_t)howBig);
+}
+inline long random(long howSmall, long howBig) { return (howSmall >= howBig) ? howSmall : howSmall + random(howBig - howSmall); }
+
+inline long map(long x, long inMin, long inMax, long outMin, long outMax)
+{
+  return (inMax == inMin) ? outMin : (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+template <class T, class L, class H> T constrain(T x, L low, H high) { return (x < low) ? low : ((x > high) ? high : x); }
+
+#endif // NATIVE_ARDUINO_H
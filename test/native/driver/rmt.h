@@ -0,0 +1,161 @@
+#ifndef NATIVE_DRIVER_RMT_H
+#define NATIVE_DRIVER_RMT_H
+
+//-- Host (env:native) RMT driver (IDF 4 API). rmt_write_sample() runs the
+//-- translator the way the driver does: first the whole channel memory,
+//-- then half of it at a time. The symbols are turned back into bytes as a
+//-- WS2812 does (a high time over 650ns is a 1), so a test can read what
+//-- the LEDs on a pin got.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "freertos/FreeRTOS.h"
+#include "esp_intr_alloc.h"
+
+typedef int esp_err_t;
+#define ESP_OK    0
+#define ESP_FAIL -1
+
+typedef int gpio_num_t;
+
+typedef enum
+{
+  RMT_CHANNEL_0, RMT_CHANNEL_1, RMT_CHANNEL_2, RMT_CHANNEL_3,
+  RMT_CHANNEL_4, RMT_CHANNEL_5, RMT_CHANNEL_6, RMT_CHANNEL_7, RMT_CHANNEL_MAX
+} rmt_channel_t;
+
+typedef enum { RMT_MODE_TX, RMT_MODE_RX } rmt_mode_t;
+
+typedef struct
+{
+  union
+  {
+    struct
+    {
+      uint32_t duration0 : 15;
+      uint32_t level0    : 1;
+      uint32_t duration1 : 15;
+      uint32_t level1    : 1;
+    };
+    uint32_t val;
+  };
+} rmt_item32_t;
+
+typedef struct
+{
+  rmt_mode_t    rmt_mode;
+  rmt_channel_t channel;
+  gpio_num_t    gpio_num;
+  uint8_t       clk_div;
+  uint8_t       mem_block_num;
+  uint32_t      flags;
+} rmt_config_t;
+
+#define RMT_MEM_ITEM_NUM  64
+#define RMT_DEFAULT_CONFIG_TX(gpio, channel_id) { RMT_MODE_TX, channel_id, gpio, 80, 1, 0 }
+
+typedef void (*sample_to_rmt_t)(const void* src, rmt_item32_t* dest, size_t src_size
+                              , size_t wanted_num, size_t* translated_size, size_t* item_num);
+
+struct NativeRmtChannel
+{
+  bool                 installed = false;
+  rmt_config_t         config = RMT_DEFAULT_CONFIG_TX(-1, RMT_CHANNEL_0);
+  int                  intrFlags = 0;   // as given to rmt_driver_install()
+  sample_to_rmt_t      translator = nullptr;
+  std::vector<uint8_t> received;      // bytes of the last rmt_write_sample()
+  uint32_t             writes = 0;
+  uint32_t             badSymbols = 0;  // symbols that are not high-then-low
+};
+
+inline NativeRmtChannel* nativeRmtChannels() { static NativeRmtChannel channels[RMT_CHANNEL_MAX]; return channels; }
+
+// Benchmarks turn this off: the ESP32 encodes in the interrupt, off the
+// render path, so rmt_write_sample() then only counts the write
+inline bool& nativeRmtDecode() { static bool decode = true; return decode; }
+
+inline esp_err_t rmt_config(const rmt_config_t* config)
+{
+  if (config->channel >= RMT_CHANNEL_MAX || config->channel + config->mem_block_num > RMT_CHANNEL_MAX) return ESP_FAIL;
+  nativeRmtChannels()[config->channel].config = *config;
+  return ESP_OK;
+}
+
+inline esp_err_t rmt_driver_install(rmt_channel_t channel, size_t, int intrFlags)
+{
+  if (channel >= RMT_CHANNEL_MAX || nativeRmtChannels()[channel].installed) return ESP_FAIL;
+  nativeRmtChannels()[channel].installed = true;
+  nativeRmtChannels()[channel].intrFlags = intrFlags;
+  return ESP_OK;
+}
+
+inline esp_err_t rmt_driver_uninstall(rmt_channel_t channel)
+{
+  if (channel >= RMT_CHANNEL_MAX) return ESP_FAIL;
+  nativeRmtChannels()[channel] = NativeRmtChannel();
+  return ESP_OK;
+}
+
+inline esp_err_t rmt_translator_init(rmt_channel_t channel, sample_to_rmt_t translator)
+{
+  if (channel >= RMT_CHANNEL_MAX || !nativeRmtChannels()[channel].installed) return ESP_FAIL;
+  nativeRmtChannels()[channel].translator = translator;
+  return ESP_OK;
+}
+
+inline esp_err_t rmt_write_sample(rmt_channel_t channel, const uint8_t* src, size_t size, bool)
+{
+  if (channel >= RMT_CHANNEL_MAX) return ESP_FAIL;
+  NativeRmtChannel& rmt = nativeRmtChannels()[channel];
+  if (!rmt.installed || rmt.translator == nullptr) return ESP_FAIL;
+
+  size_t memItems = (size_t)rmt.config.mem_block_num * RMT_MEM_ITEM_NUM;
+  uint32_t oneTicks = 650 * 80 / 1000 / (rmt.config.clk_div ? rmt.config.clk_div : 1);  // 650ns
+  std::vector<rmt_item32_t> items(memItems);
+  rmt.received.clear();
+  rmt.writes++;
+  if (!nativeRmtDecode()) return ESP_OK;
+
+  size_t wanted = memItems;
+  while (size > 0)
+  {
+    size_t translated = 0;
+    size_t itemCount  = 0;
+    rmt.translator(src, items.data(), size, wanted, &translated, &itemCount);
+    if (translated == 0 || translated > size || itemCount > wanted) return ESP_FAIL;
+
+    for (size_t i = 0; i + 8 <= itemCount; i += 8)
+    {
+      uint8_t value = 0;
+      for (size_t b = 0; b < 8; b++)
+      {
+        const rmt_item32_t& item = items[i + b];
+        if (item.level0 != 1 || item.level1 != 0) rmt.badSymbols++;
+        value = (value << 1) | ((item.duration0 > oneTicks) ? 1 : 0);
+      }
+      rmt.received.push_back(value);
+    }
+    src    += translated;
+    size   -= translated;
+    wanted  = memItems / 2;   // the interrupt refills half of the memory
+  }
+  return ESP_OK;
+}
+
+inline esp_err_t rmt_wait_tx_done(rmt_channel_t channel, TickType_t)
+{
+  return (channel < RMT_CHANNEL_MAX) ? ESP_OK : ESP_FAIL;
+}
+
+// The channel that sends on 'gpio', nullptr if none
+inline const NativeRmtChannel* nativeRmtPin(gpio_num_t gpio)
+{
+  for (int c = 0; c < RMT_CHANNEL_MAX; c++)
+  {
+    if (nativeRmtChannels()[c].installed && nativeRmtChannels()[c].config.gpio_num == gpio) return &nativeRmtChannels()[c];
+  }
+  return nullptr;
+}
+
+#endif // NATIVE_DRIVER_RMT_H
@@ -0,0 +1,10 @@
+#ifndef NATIVE_ESP_IDF_VERSION_H
+#define NATIVE_ESP_IDF_VERSION_H
+
+//-- Host (env:native): the IDF 4 core, so frames go out through driver/rmt.h
+
+#define ESP_IDF_VERSION_MAJOR 4
+#define ESP_IDF_VERSION_MINOR 4
+#define ESP_IDF_VERSION_PATCH 0
+
+#endif // NATIVE_ESP_IDF_VERSION_H
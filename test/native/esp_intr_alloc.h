@@ -0,0 +1,9 @@
+#ifndef NATIVE_ESP_INTR_ALLOC_H
+#define NATIVE_ESP_INTR_ALLOC_H
+
+//-- Host (env:native) interrupt allocation flags
+
+#define ESP_INTR_FLAG_LEVEL1  (1 << 1)
+#define ESP_INTR_FLAG_IRAM    (1 << 10)   // the handler runs while the flash is written
+
+#endif // NATIVE_ESP_INTR_ALLOC_H
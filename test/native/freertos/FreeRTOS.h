@@ -0,0 +1,27 @@
+#ifndef NATIVE_FREERTOS_H
+#define NATIVE_FREERTOS_H
+
+//-- Host (env:native): there are no tasks, the display classes run from
+//-- their loop() in the test. Creating a task or a queue fails.
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef int          BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t     TickType_t;
+
+#define pdFALSE             0
+#define pdTRUE              1
+#define pdFAIL              pdFALSE
+#define pdPASS              pdTRUE
+#define portMAX_DELAY       0xFFFFFFFFUL
+#define portTICK_PERIOD_MS  1
+#define pdMS_TO_TICKS(ms)   ((TickType_t)(ms))
+
+typedef struct { uint32_t owner; uint32_t count; } portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED  {0, 0}
+inline void portENTER_CRITICAL(portMUX_TYPE*) {}
+inline void portEXIT_CRITICAL(portMUX_TYPE*) {}
+
+#endif // NATIVE_FREERTOS_H
@@ -0,0 +1,13 @@
+#ifndef NATIVE_FREERTOS_QUEUE_H
+#define NATIVE_FREERTOS_QUEUE_H
+
+#include "FreeRTOS.h"
+
+typedef void* QueueHandle_t;
+
+inline QueueHandle_t xQueueCreate(UBaseType_t, UBaseType_t) { return nullptr; }
+inline BaseType_t    xQueueSend(QueueHandle_t, const void*, TickType_t) { return pdFALSE; }
+inline BaseType_t    xQueueReceive(QueueHandle_t, void*, TickType_t) { return pdFALSE; }
+inline UBaseType_t   uxQueueMessagesWaiting(QueueHandle_t) { return 0; }
+
+#endif // NATIVE_FREERTOS_QUEUE_H
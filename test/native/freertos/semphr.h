@@ -0,0 +1,12 @@
+#ifndef NATIVE_FREERTOS_SEMPHR_H
+#define NATIVE_FREERTOS_SEMPHR_H
+
+#include "queue.h"
+
+typedef void* SemaphoreHandle_t;
+
+inline SemaphoreHandle_t xSemaphoreCreateMutex() { return nullptr; }
+inline BaseType_t        xSemaphoreTake(SemaphoreHandle_t, TickType_t) { return pdTRUE; }
+inline BaseType_t        xSemaphoreGive(SemaphoreHandle_t) { return pdTRUE; }
+
+#endif // NATIVE_FREERTOS_SEMPHR_H
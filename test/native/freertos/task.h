@@ -0,0 +1,21 @@
+#ifndef NATIVE_FREERTOS_TASK_H
+#define NATIVE_FREERTOS_TASK_H
+
+#include "FreeRTOS.h"
+
+typedef void* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t, const char*, uint32_t, void*
+                                         , UBaseType_t, TaskHandle_t* handle, BaseType_t)
+{
+  if (handle != nullptr) *handle = nullptr;
+  return pdFAIL;
+}
+inline TaskHandle_t xTaskGetCurrentTaskHandle() { return nullptr; }
+inline void         vTaskDelay(TickType_t) {}
+inline void         vTaskDelete(TaskHandle_t) {}
+inline TickType_t   xTaskGetTickCount() { return 0; }
+inline BaseType_t   xPortGetCoreID() { return 1; }
+
+#endif // NATIVE_FREERTOS_TASK_H
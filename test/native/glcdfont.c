@@ -0,0 +1,10 @@
+//-- Host (env:native) stand-in for the classic 5x7 font of Adafruit GFX,
+//-- which is not part of this tree: every glyph is blank. The golden frames
+//-- use the proportional font (setProportionalFont(true)).
+
+#ifndef FONT5X7_H
+#define FONT5X7_H
+
+static const unsigned char font[256 * 5] = {0};
+
+#endif // FONT5X7_H
@@ -0,0 +1,209 @@
+//-- Host benchmarks of the NeopixelsClass frame paths, next to the golden
+//-- frame tests (test_neopixels_frames). Every case first checks that the
+//-- paths it compares give the same frames, then prints the time per frame.
+//-- run with: pio test -e native -f test_neopixels_benchmark -v
+//--
+//-- A frame is timed from animateNeopixels() to the LED bytes through the
+//-- level LUT; the RMT symbols are not made (on the ESP32 the interrupt does
+//-- that, see test_neopixels_encoder). Host numbers, not target numbers.
+
+#include <unity.h>
+#include <vector>
+#include <chrono>
+#include "NeopixelsClass.h"
+
+#define DATA_PIN         5
+#define HASHED_FRAMES  300
+#define TIMED_FRAMES 20000
+
+static const char* benchText = "The quick brown fox jumps over the lazy dog, 0123456789. "
+                               "Het weer: zonnig, 21 graden en een zwakke wind uit het zuiden. ";
+
+struct Layout
+{
+  int         width;
+  int         height;
+  uint8_t     layout;
+  const char* name;
+};
+
+static const Layout layouts[8] =
+{
+  { 32,  8, NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS    + NEO_MATRIX_PROGRESSIVE, "rows progr.   " },
+  { 32,  8, NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_COLUMNS + NEO_MATRIX_ZIGZAG,      "columns zigzag" },
+  { 64,  8, NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS    + NEO_MATRIX_PROGRESSIVE, "rows progr.   " },
+  { 64,  8, NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_COLUMNS + NEO_MATRIX_ZIGZAG,      "columns zigzag" },
+  {128, 16, NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS    + NEO_MATRIX_PROGRESSIVE, "rows progr.   " },
+  {128, 16, NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS    + NEO_MATRIX_ZIGZAG,      "rows zigzag   " },
+  {128, 16, NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_COLUMNS + NEO_MATRIX_PROGRESSIVE, "columns progr." },
+  {128, 16, NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_COLUMNS + NEO_MATRIX_ZIGZAG,      "columns zigzag" }
+};
+
+void setUp()    { nativeRmtDecode() = false; }
+void tearDown() { nativeRmtDecode() = true; }
+
+
+static void startTicker(NeopixelsClass& ticker, const Layout& l)
+{
+  ticker.setup(l.layout & NEO_MATRIX_BOTTOM, l.layout & NEO_MATRIX_AXIS, l.layout & NEO_MATRIX_RIGHT, l.layout & NEO_MATRIX_SEQUENCE);
+  ticker.setMatrixSize(l.width, l.height);
+  ticker.setPixelType(NEO_GRB + NEO_KHZ800);
+  ticker.begin(DATA_PIN);
+  ticker.setPixelsPerChar(6);
+  ticker.setProportionalFont(true);
+  ticker.setIntensity(100);
+  ticker.setColor(255, 160, 0);
+  ticker.setRandomEffects({PA_NO_EFFECT});
+
+} // startTicker()
+
+
+// FNV-1a over the frame hashes of 'frames' pixel steps of benchText
+static uint32_t hashFrames(NeopixelsClass& ticker, int frames)
+{
+  uint32_t sequence = 2166136261u;
+  ticker.setFrameSink([&sequence](const VirtualMatrix& frame)
+  {
+    uint32_t hash = frame.hash();
+    for (int i = 0; i < 4; i++) sequence = (sequence ^ (uint8_t)(hash >> (8 * i))) * 16777619u;
+  });
+  ticker.sendNextText(benchText);
+  for (int f = 0; f < frames; f++) ticker.animateNeopixels(false);
+  ticker.setFrameSink(nullptr);
+  return sequence;
+
+} // hashFrames()
+
+
+// Microseconds per pixel step of benchText, a new text when one is done
+static double timeSteps(NeopixelsClass& ticker, int frames)
+{
+  bool finished = false;
+  ticker.setCallback([&finished](const std::string&) { finished = true; });
+  ticker.sendNextText(benchText);
+
+  auto start = std::chrono::steady_clock::now();
+  for (int f = 0; f < frames; f++)
+  {
+    ticker.animateNeopixels(true);
+    if (finished)
+    {
+      finished = false;
+      ticker.sendNextText(benchText);
+    }
+  }
+  double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+  ticker.setCallback(nullptr);
+  return us / frames;
+
+} // timeSteps()
+
+
+// Scrolling one column: the previous frame shifted in the buffer with only
+// the new right column drawn, against every visible column drawn again
+void test_benchmark_shift()
+{
+  TEST_MESSAGE("size    layout          full draw   shift    (us per frame)");
+  for (const Layout& l : layouts)
+  {
+    uint32_t hashes[2];
+    double   frameUs[2];
+    for (int shift = 0; shift < 2; shift++)
+    {
+      NeopixelsClass ticker;   // its RMT channel is released when it goes
+      startTicker(ticker, l);
+      ticker.setIncrementalScroll(shift);
+      hashes[shift]  = hashFrames(ticker, HASHED_FRAMES);
+      frameUs[shift] = timeSteps(ticker, TIMED_FRAMES);
+    }
+    TEST_ASSERT_EQUAL_HEX32(hashes[0], hashes[1]);
+    double fullUs  = frameUs[0];
+    double shiftUs = frameUs[1];
+
+    char line[96];
+    snprintf(line, sizeof(line), "%3dx%-3d %s %8.2f %8.2f", l.width, l.height, l.name, fullUs, shiftUs);
+    TEST_MESSAGE(line);
+  }
+
+} // test_benchmark_shift()
+
+
+// Scroll benchText by the clock for 'columns' pixel steps at the slowest
+// speed, loop() every millisecond. Returns the microseconds per frame sent;
+// the frames are counted by the RMT writes (one pin, unchanged frames are
+// not sent). With 'hashes' every frame is hashed into it instead of timed.
+static double scrollByClock(NeopixelsClass& ticker, int columns, int& frames, std::vector<uint32_t>* hashes = nullptr)
+{
+  if (hashes != nullptr) ticker.setFrameSink([hashes](const VirtualMatrix& frame) { hashes->push_back(frame.hash()); });
+  ticker.setScrollSpeed(0);   // 100ms per column
+  ticker.sendNextText(benchText);
+  uint32_t writesBefore = nativeRmtPin(DATA_PIN)->writes;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int ms = 0; ms < columns * 100; ms++)
+  {
+    nativeAdvanceMicros(1000);
+    ticker.loop();
+  }
+  double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+  ticker.setFrameSink(nullptr);
+  frames = nativeRmtPin(DATA_PIN)->writes - writesBefore;
+  return (frames > 0) ? us / frames : 0;
+
+} // scrollByClock()
+
+
+// Sub-pixel scrolling: between two pixel steps blended frames move the text
+// part of a column. The pixel step frames must stay what they are without it.
+void test_benchmark_subpixel()
+{
+  static const Layout sizes[3] =
+  {
+    { 32,  8, NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS + NEO_MATRIX_PROGRESSIVE, "rows progr.   " },
+    { 64,  8, NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS + NEO_MATRIX_PROGRESSIVE, "rows progr.   " },
+    { 32, 16, NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS + NEO_MATRIX_ZIGZAG,      "rows zigzag   " }
+  };
+  const int columns = 60;
+
+  TEST_MESSAGE("size    layout          pixel steps   sub-pixel  frames/column  (us per frame)");
+  for (const Layout& l : sizes)
+  {
+    std::vector<uint32_t> hashes[2];
+    double frameUs[2];
+    int    frames[2];
+    for (int subPixel = 0; subPixel < 2; subPixel++)
+    {
+      NeopixelsClass ticker;
+      startTicker(ticker, l);
+      ticker.setSubPixelScroll(subPixel);
+      int hashedFrames;
+      scrollByClock(ticker, columns, hashedFrames, &hashes[subPixel]);
+      frameUs[subPixel] = scrollByClock(ticker, columns, frames[subPixel]);
+    }
+
+    // Every pixel step frame is among the sub-pixel frames, in order
+    size_t found = 0;
+    for (uint32_t hash : hashes[1])
+    {
+      if (found < hashes[0].size() && hash == hashes[0][found]) found++;
+    }
+    TEST_ASSERT_EQUAL(hashes[0].size(), found);
+    TEST_ASSERT_TRUE(frames[1] > 2 * frames[0]);
+
+    char line[112];
+    snprintf(line, sizeof(line), "%3dx%-3d %s %8.2f %11.2f %10.1f"
+                               , l.width, l.height, l.name, frameUs[0], frameUs[1], (double)frames[1] / frames[0]);
+    TEST_MESSAGE(line);
+  }
+
+} // test_benchmark_subpixel()
+
+
+int main(int argc, char** argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_benchmark_shift);
+  RUN_TEST(test_benchmark_subpixel);
+  return UNITY_END();
+
+} // main()
@@ -0,0 +1,194 @@
+//-- Golden symbol streams of the RMT encoder (include/NeopixelsEncoder.h)
+//-- run with: pio test -e native -f test_neopixels_encoder
+//-- test_benchmark_frame prints the host time to encode one 512 pixel frame
+//-- (pio test -e native -f test_neopixels_encoder -v shows it).
+
+#include <unity.h>
+#include <string.h>
+#include <stdio.h>
+#include <chrono>
+#include "NeopixelsEncoder.h"
+
+// An rmt_item32_t is duration0:15 level0:1 duration1:15 level1:1
+static const uint32_t ZERO_800 = 0x00228010;  // 16 ticks high, 34 ticks low
+static const uint32_t ONE_800  = 0x00128020;  // 32 ticks high, 18 ticks low
+static const uint32_t ZERO_400 = 0x00508014;  // 20 ticks high, 80 ticks low
+static const uint32_t ONE_400  = 0x00348030;  // 48 ticks high, 52 ticks low
+static const uint32_t UNTOUCHED = 0xDEADBEEF;
+
+void setUp() {}
+void tearDown() {}
+
+
+void test_symbols()
+{
+  TEST_ASSERT_EQUAL_HEX32(ZERO_800, neoSymbol(neoTiming800.t0h, neoTiming800.t0l));
+  TEST_ASSERT_EQUAL_HEX32(ONE_800,  neoSymbol(neoTiming800.t1h, neoTiming800.t1l));
+  TEST_ASSERT_EQUAL_HEX32(ZERO_400, neoSymbol(neoTiming400.t0h, neoTiming400.t0l));
+  TEST_ASSERT_EQUAL_HEX32(ONE_400,  neoSymbol(neoTiming400.t1h, neoTiming400.t1l));
+
+} // test_symbols()
+
+
+void test_stream_800()
+{
+  const uint8_t src[3] = {0xA5, 0x00, 0xFF};
+  const uint32_t golden[24] =
+  {
+    ONE_800,  ZERO_800, ONE_800,  ZERO_800, ZERO_800, ONE_800,  ZERO_800, ONE_800,   // 0xA5
+    ZERO_800, ZERO_800, ZERO_800, ZERO_800, ZERO_800, ZERO_800, ZERO_800, ZERO_800,  // 0x00
+    ONE_800,  ONE_800,  ONE_800,  ONE_800,  ONE_800,  ONE_800,  ONE_800,  ONE_800    // 0xFF
+  };
+  uint32_t dest[24];
+  size_t bytesUsed = 0;
+
+  TEST_ASSERT_EQUAL(24, neoEncodeBytes(src, 3, dest, 24, neoTiming800, bytesUsed));
+  TEST_ASSERT_EQUAL(3, bytesUsed);
+  TEST_ASSERT_EQUAL_HEX32_ARRAY(golden, dest, 24);
+
+} // test_stream_800()
+
+
+void test_stream_400()
+{
+  const uint8_t src[2] = {0x81, 0x3C};
+  const uint32_t golden[16] =
+  {
+    ONE_400,  ZERO_400, ZERO_400, ZERO_400, ZERO_400, ZERO_400, ZERO_400, ONE_400,   // 0x81
+    ZERO_400, ZERO_400, ONE_400,  ONE_400,  ONE_400,  ONE_400,  ZERO_400, ZERO_400   // 0x3C
+  };
+  uint32_t dest[16];
+  size_t bytesUsed = 0;
+
+  TEST_ASSERT_EQUAL(16, neoEncodeBytes(src, 2, dest, 16, neoTiming400, bytesUsed));
+  TEST_ASSERT_EQUAL(2, bytesUsed);
+  TEST_ASSERT_EQUAL_HEX32_ARRAY(golden, dest, 16);
+
+} // test_stream_400()
+
+
+// The driver asks for a number of symbols that need not be a multiple of 8:
+// only whole bytes are encoded, the symbols after them are left alone
+void test_partial_destination()
+{
+  const uint8_t src[4] = {0xFF, 0x00, 0xFF, 0x00};
+  uint32_t dest[20];
+  size_t bytesUsed = 0;
+  for (int i = 0; i < 20; i++) dest[i] = UNTOUCHED;
+
+  TEST_ASSERT_EQUAL(16, neoEncodeBytes(src, 4, dest, 20, neoTiming800, bytesUsed));
+  TEST_ASSERT_EQUAL(2, bytesUsed);
+  TEST_ASSERT_EQUAL_HEX32(ONE_800,  dest[7]);
+  TEST_ASSERT_EQUAL_HEX32(ZERO_800, dest[15]);
+  for (int i = 16; i < 20; i++) TEST_ASSERT_EQUAL_HEX32(UNTOUCHED, dest[i]);
+
+  // Less than one byte of room: nothing
+  TEST_ASSERT_EQUAL(0, neoEncodeBytes(src, 4, dest, 7, neoTiming800, bytesUsed));
+  TEST_ASSERT_EQUAL(0, bytesUsed);
+
+} // test_partial_destination()
+
+
+// The last chunk of a frame: fewer bytes left than there is room for
+void test_short_source()
+{
+  const uint8_t src[3] = {0x01, 0x02, 0x80};
+  uint32_t dest[64];
+  size_t bytesUsed = 0;
+  for (int i = 0; i < 64; i++) dest[i] = UNTOUCHED;
+
+  TEST_ASSERT_EQUAL(24, neoEncodeBytes(src, 3, dest, 64, neoTiming400, bytesUsed));
+  TEST_ASSERT_EQUAL(3, bytesUsed);
+  TEST_ASSERT_EQUAL_HEX32(ONE_400,  dest[7]);
+  TEST_ASSERT_EQUAL_HEX32(ONE_400,  dest[14]);
+  TEST_ASSERT_EQUAL_HEX32(ONE_400,  dest[16]);
+  TEST_ASSERT_EQUAL_HEX32(ZERO_400, dest[23]);
+  TEST_ASSERT_EQUAL_HEX32(UNTOUCHED, dest[24]);
+
+  TEST_ASSERT_EQUAL(0, neoEncodeBytes(src, 0, dest, 64, neoTiming400, bytesUsed));
+  TEST_ASSERT_EQUAL(0, bytesUsed);
+
+} // test_short_source()
+
+
+// The RMT interrupt refills half of the channel memory at a time and moves
+// the source on by bytesUsed; chunk by chunk the stream must be the same as
+// in one go
+void test_chunks_make_the_stream()
+{
+  uint8_t src[45];
+  for (int i = 0; i < 45; i++) src[i] = (uint8_t)(i * 37 + 11);
+
+  uint32_t whole[45 * 8];
+  size_t bytesUsed = 0;
+  TEST_ASSERT_EQUAL(45 * 8, neoEncodeBytes(src, 45, whole, 45 * 8, neoTiming800, bytesUsed));
+
+  uint32_t chunked[45 * 8];
+  size_t position = 0;
+  size_t symbols  = 0;
+  int    calls    = 0;
+  while (position < 45)
+  {
+    size_t n = neoEncodeBytes(src + position, 45 - position, chunked + symbols, 60, neoTiming800, bytesUsed);
+    TEST_ASSERT_EQUAL(bytesUsed * 8, n);
+    position += bytesUsed;
+    symbols  += n;
+    calls++;
+  }
+  TEST_ASSERT_EQUAL(45, position);
+  TEST_ASSERT_EQUAL(7, calls);  // 60 symbols hold 7 bytes: 6 chunks of 7 and one of 3
+  TEST_ASSERT_EQUAL_HEX32_ARRAY(whole, chunked, 45 * 8);
+
+} // test_chunks_make_the_stream()
+
+
+// Host benchmark: a 512 pixel GRB frame encoded the way the driver asks for
+// it, 256 symbols first and then 128 at a time. Only checked against the
+// wire time, the number is printed.
+void test_benchmark_frame()
+{
+  const size_t frameBytes = 512 * 3;
+  const int    frames     = 2000;
+  static uint8_t  src[frameBytes];
+  static uint32_t items[256];
+  for (size_t i = 0; i < frameBytes; i++) src[i] = (uint8_t)(i * 37 + 11);
+
+  uint32_t checksum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int f = 0; f < frames; f++)
+  {
+    size_t position = 0;
+    size_t wanted   = 256;
+    while (position < frameBytes)
+    {
+      size_t bytesUsed = 0;
+      size_t n = neoEncodeBytes(src + position, frameBytes - position, items, wanted, neoTiming800, bytesUsed);
+      checksum += items[n - 1];
+      position += bytesUsed;
+      wanted    = 128;
+    }
+    src[f % frameBytes]++;   // a new frame, the loop is not optimised away
+  }
+  double frameUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / frames;
+
+  char message[96];
+  snprintf(message, sizeof(message), "encode 512 pixels: %.2f us per frame (wire time 15360 us) [%08x]", frameUs, (unsigned)checksum);
+  TEST_MESSAGE(message);
+  TEST_ASSERT_TRUE(frameUs < 15360.0);
+
+} // test_benchmark_frame()
+
+
+int main(int argc, char** argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_symbols);
+  RUN_TEST(test_stream_800);
+  RUN_TEST(test_stream_400);
+  RUN_TEST(test_partial_destination);
+  RUN_TEST(test_short_source);
+  RUN_TEST(test_chunks_make_the_stream);
+  RUN_TEST(test_benchmark_frame);
+  return UNITY_END();
+
+} // main()
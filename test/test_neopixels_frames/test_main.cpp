@@ -0,0 +1,303 @@
+//-- Golden frames of NeopixelsClass on the host: known texts and exit effects
+//-- are rendered through the fake matrix (test/native) and every frame is
+//-- hashed (VirtualMatrix::hash()). The hashes of all frames of a text are
+//-- hashed again into one golden value per case.
+//-- run with: pio test -e native -f test_neopixels_frames
+//-- With NEO_FRAMES_DIR set every frame is written there as a PPM file.
+//--
+//-- The frames use the proportional font (the classic font is not part of
+//-- the host build) and gamma 1.0, so no float math decides a LED value.
+
+#include <unity.h>
+#include <vector>
+#include "NeopixelsClass.h"
+
+#define MATRIX_WIDTH   32
+#define MATRIX_HEIGHT   8
+#define DATA_PIN        5
+#define BLANK_FRAME    0x0F5A670Du   // hash of an all black 32x8 frame
+
+struct Recording
+{
+  std::vector<uint32_t> hashes;
+  uint32_t sequence = 2166136261u;   // FNV-1a over all frame hashes
+  bool     finished = false;
+  int      wireErrors = 0;           // frames the LEDs did not get as shown
+};
+
+void setUp() {}
+void tearDown() {}
+
+
+// LED index of (x, y) for a NEO_MATRIX_* layout of one panel
+static int ledIndex(int x, int y, uint8_t layout, int width, int height)
+{
+  int column = (layout & NEO_MATRIX_RIGHT)  ? width - 1 - x  : x;
+  int row    = (layout & NEO_MATRIX_BOTTOM) ? height - 1 - y : y;
+  bool columns = (layout & NEO_MATRIX_COLUMNS) != 0;
+  int major = columns ? column : row;
+  int minor = columns ? row : column;
+  int majorSize = columns ? height : width;
+  if ((layout & NEO_MATRIX_ZIGZAG) && (major & 1)) minor = majorSize - 1 - minor;
+  return major * majorSize + minor;
+
+} // ledIndex()
+
+
+// Count the pixels of the frame that the RMT channel of 'pin' did not send
+// as GRB bytes at their place in the chain. 'firstColumn' is the left
+// column of the panels on this pin.
+static int wireErrors(const VirtualMatrix& frame, int pin, uint8_t layout, int panelWidth, int firstColumn, int panelCount)
+{
+  const NativeRmtChannel* channel = nativeRmtPin(pin);
+  if (channel == nullptr) return 1;
+  if (channel->badSymbols > 0 || channel->received.size() != (size_t)panelCount * panelWidth * MATRIX_HEIGHT * 3) return 1;
+
+  int errors = 0;
+  for (int y = 0; y < MATRIX_HEIGHT; y++)
+  {
+    for (int x = 0; x < panelWidth * panelCount; x++)
+    {
+      int panel = x / panelWidth;
+      size_t led = (size_t)panel * panelWidth * MATRIX_HEIGHT + ledIndex(x % panelWidth, y, layout, panelWidth, MATRIX_HEIGHT);
+      const uint8_t* wire  = &channel->received[led * 3];
+      const uint8_t* shown = &frame.getPixels()[((size_t)y * frame.getWidth() + firstColumn + x) * 3];
+      if (wire[1] != shown[0] || wire[0] != shown[1] || wire[2] != shown[2]) errors++;
+    }
+  }
+  return errors;
+
+} // wireErrors()
+
+
+static void startTicker(NeopixelsClass& ticker, uint8_t layout, int panels = 1, const std::vector<uint8_t>& pins = {})
+{
+  ticker.setup(layout & NEO_MATRIX_BOTTOM, layout & NEO_MATRIX_AXIS, layout & NEO_MATRIX_RIGHT, layout & NEO_MATRIX_SEQUENCE);
+  ticker.setMatrixSize(MATRIX_WIDTH / panels, MATRIX_HEIGHT);
+  ticker.setPanels(panels, pins);
+  ticker.setPixelType(NEO_GRB + NEO_KHZ800);
+  ticker.begin(DATA_PIN);
+  ticker.setPixelsPerChar(6);
+  ticker.setProportionalFont(true);
+  ticker.setGamma(1.0f);
+  ticker.setIntensity(100);
+
+} // startTicker()
+
+
+// Scroll 'text' with exit effect 'effect' until it is finished
+static Recording record(NeopixelsClass& ticker, const char* text, uint8_t effect, uint8_t r, uint8_t g, uint8_t b
+                      , uint8_t layout = NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS + NEO_MATRIX_PROGRESSIVE)
+{
+  Recording recording;
+  const char* framesDir = getenv("NEO_FRAMES_DIR");
+
+  ticker.setRandomEffects({effect});
+  ticker.setColor(r, g, b);
+  ticker.setCallback([&recording](const std::string&) { recording.finished = true; });
+  ticker.setFrameSink([&](const VirtualMatrix& frame)
+  {
+    uint32_t hash = frame.hash();
+    recording.hashes.push_back(hash);
+    for (int i = 0; i < 4; i++) recording.sequence = (recording.sequence ^ (uint8_t)(hash >> (8 * i))) * 16777619u;
+    recording.wireErrors += (wireErrors(frame, DATA_PIN, layout, MATRIX_WIDTH, 0, 1) > 0) ? 1 : 0;
+    if (framesDir != nullptr)
+    {
+      char pattern[128];
+      snprintf(pattern, sizeof(pattern), "%s/%s_%d_%%04u.ppm", framesDir, text, effect);
+      frame.writeFrame(pattern, recording.hashes.size() - 1, 8);
+    }
+  });
+
+  ticker.sendNextText(text);
+  for (int step = 0; step < 500 && !recording.finished; step++) ticker.animateNeopixels(true);
+  ticker.setFrameSink(nullptr);
+  return recording;
+
+} // record()
+
+
+void test_scroll_frames()
+{
+  NeopixelsClass ticker;
+  startTicker(ticker, NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS + NEO_MATRIX_PROGRESSIVE);
+  Recording recording = record(ticker, "HELLO", PA_NO_EFFECT, 255, 0, 0);
+
+  TEST_ASSERT_TRUE(recording.finished);
+  TEST_ASSERT_EQUAL(32, recording.hashes.size());
+  TEST_ASSERT_EQUAL_HEX32(BLANK_FRAME, recording.hashes[0]);
+  TEST_ASSERT_EQUAL_HEX32(0x5C1B6203, recording.sequence);
+  TEST_ASSERT_EQUAL(0, recording.wireErrors);
+
+} // test_scroll_frames()
+
+
+// The layout only changes where a pixel is in the chain, not the frame
+void test_layouts_give_the_same_frames()
+{
+  Recording expected;
+  {
+    NeopixelsClass rows;   // its RMT channel is released when it goes
+    startTicker(rows, NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS + NEO_MATRIX_PROGRESSIVE);
+    expected = record(rows, "Zig", PA_NO_EFFECT, 0, 200, 50);
+  }
+
+  const uint8_t layouts[3] =
+  {
+    NEO_MATRIX_TOP    + NEO_MATRIX_LEFT  + NEO_MATRIX_ROWS    + NEO_MATRIX_ZIGZAG,
+    NEO_MATRIX_BOTTOM + NEO_MATRIX_RIGHT + NEO_MATRIX_COLUMNS + NEO_MATRIX_PROGRESSIVE,
+    NEO_MATRIX_TOP    + NEO_MATRIX_RIGHT + NEO_MATRIX_COLUMNS + NEO_MATRIX_ZIGZAG
+  };
+  for (uint8_t layout : layouts)
+  {
+    NeopixelsClass ticker;
+    startTicker(ticker, layout);
+    Recording recording = record(ticker, "Zig", PA_NO_EFFECT, 0, 200, 50, layout);
+    TEST_ASSERT_EQUAL(expected.hashes.size(), recording.hashes.size());
+    TEST_ASSERT_EQUAL_HEX32(expected.sequence, recording.sequence);
+    TEST_ASSERT_EQUAL(0, recording.wireErrors);
+  }
+
+} // test_layouts_give_the_same_frames()
+
+
+void test_effect_frames()
+{
+  struct Case { uint8_t effect; int frames; uint32_t sequence; };
+  const Case cases[4] =
+  {
+    {PA_SCROLL_UP, 41, 0x9395DCB4},
+    {PA_FADE,      49, 0xC0E13F31},
+    {PA_DISSOLVE,  65, 0xB7D2084F},
+    {PA_WIPE,      65, 0x78D4C61C}
+  };
+  for (const Case& c : cases)
+  {
+    NeopixelsClass ticker;
+    startTicker(ticker, NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS + NEO_MATRIX_PROGRESSIVE);
+    Recording recording = record(ticker, "HELLO", c.effect, 255, 160, 0);
+
+    TEST_ASSERT_TRUE(recording.finished);
+    TEST_ASSERT_EQUAL(c.frames, recording.hashes.size());
+    TEST_ASSERT_EQUAL_HEX32(BLANK_FRAME, recording.hashes.back());   // the text has left
+    TEST_ASSERT_EQUAL_HEX32(c.sequence, recording.sequence);
+    TEST_ASSERT_EQUAL(0, recording.wireErrors);
+  }
+
+} // test_effect_frames()
+
+
+// PA_FADE dims the scrolling text, the static layer left of it stays as it is
+void test_fade_keeps_the_layers()
+{
+  NeopixelsClass ticker;
+  startTicker(ticker, NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS + NEO_MATRIX_PROGRESSIVE);
+  ticker.setStaticText("12", 12, 0, 0, 255);
+
+  std::vector<uint8_t> layer;   // the static layer columns of the first frame
+  int layerChanges = 0;
+  int dimmedFrames = 0;
+  bool finished = false;
+  ticker.setRandomEffects({PA_FADE});
+  ticker.setColor(255, 0, 0);
+  ticker.setCallback([&finished](const std::string&) { finished = true; });
+  ticker.setFrameSink([&](const VirtualMatrix& frame)
+  {
+    std::vector<uint8_t> left;
+    uint8_t textMax = 0;
+    for (int y = 0; y < MATRIX_HEIGHT; y++)
+    {
+      const uint8_t* row = &frame.getPixels()[(size_t)y * frame.getWidth() * 3];
+      left.insert(left.end(), row, row + 12 * 3);
+      for (int x = 12; x < MATRIX_WIDTH; x++) textMax = std::max(textMax, row[x * 3]);
+    }
+    if (layer.empty()) layer = left;
+    else if (left != layer) layerChanges++;
+    if (textMax > 0 && textMax < *std::max_element(layer.begin(), layer.end())) dimmedFrames++;
+  });
+  ticker.sendNextText("HI");
+  for (int step = 0; step < 500 && !finished; step++) ticker.animateNeopixels(true);
+  ticker.setFrameSink(nullptr);
+
+  TEST_ASSERT_TRUE(finished);
+  TEST_ASSERT_TRUE(*std::max_element(layer.begin(), layer.end()) > 0);
+  TEST_ASSERT_EQUAL(0, layerChanges);
+  TEST_ASSERT_TRUE(dimmedFrames > 0);
+
+} // test_fade_keeps_the_layers()
+
+
+// Two panels on pins of their own: every pin sends the panels it drives
+void test_panels_on_their_own_pins()
+{
+  NeopixelsClass ticker;
+  const uint8_t layout = NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_COLUMNS + NEO_MATRIX_ZIGZAG;
+  startTicker(ticker, layout, 2, {DATA_PIN, 18});
+
+  int errors = 0;
+  int frames = 0;
+  ticker.setRandomEffects({PA_NO_EFFECT});
+  ticker.setColor(0, 0, 255);
+  ticker.setFrameSink([&](const VirtualMatrix& frame)
+  {
+    errors += wireErrors(frame, DATA_PIN, layout, MATRIX_WIDTH / 2, 0, 1);
+    errors += wireErrors(frame, 18, layout, MATRIX_WIDTH / 2, MATRIX_WIDTH / 2, 1);
+    frames++;
+  });
+  ticker.sendNextText("Panels");
+  for (int step = 0; step < 100; step++) ticker.animateNeopixels(true);
+
+  TEST_ASSERT_TRUE(frames > 0);
+  TEST_ASSERT_EQUAL(0, errors);
+
+} // test_panels_on_their_own_pins()
+
+
+// Every channel keeps at least two memory blocks, so 4 pins can send
+// together. A list of more pins is refused, all panels go by show().
+void test_rmt_blocks_per_channel()
+{
+  {
+    NeopixelsClass ticker;
+    startTicker(ticker, NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS + NEO_MATRIX_PROGRESSIVE
+                      , 8, {5, 18, 19, 21});
+
+    int channels = 0;
+    for (int c = 0; c < RMT_CHANNEL_MAX; c++)
+    {
+      const NativeRmtChannel& channel = nativeRmtChannels()[c];
+      if (!channel.installed) continue;
+      channels++;
+      TEST_ASSERT_TRUE(channel.config.mem_block_num >= 2);
+      TEST_ASSERT_TRUE(channel.intrFlags & ESP_INTR_FLAG_IRAM);   // it runs while the flash is written
+    }
+    TEST_ASSERT_EQUAL(4, channels);
+  }
+
+  NeopixelsClass ticker;
+  startTicker(ticker, NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS + NEO_MATRIX_PROGRESSIVE
+                    , 8, {5, 18, 19, 21, 22, 23, 25, 26});
+  for (int c = 0; c < RMT_CHANNEL_MAX; c++) TEST_ASSERT_FALSE(nativeRmtChannels()[c].installed);
+
+  int frames = 0;
+  ticker.setRandomEffects({PA_NO_EFFECT});
+  ticker.setFrameSink([&frames](const VirtualMatrix&) { frames++; });
+  ticker.sendNextText("Pins");
+  for (int step = 0; step < 20; step++) ticker.animateNeopixels(true);
+  TEST_ASSERT_TRUE(frames > 0);
+
+} // test_rmt_blocks_per_channel()
+
+
+int main(int argc, char** argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_scroll_frames);
+  RUN_TEST(test_layouts_give_the_same_frames);
+  RUN_TEST(test_effect_frames);
+  RUN_TEST(test_fade_keeps_the_layers);
+  RUN_TEST(test_panels_on_their_own_pins);
+  RUN_TEST(test_rmt_blocks_per_channel);
+  return UNITY_END();
+
+} // main()